@@ -10,6 +10,7 @@ int main() {
     std::cout << "test_dense_layer  - Tests de capas densas\n";
     std::cout << "test_activations  - Tests de activaciones\n";
     std::cout << "test_convergence  - Tests de convergencia\n";
+    std::cout << "test_tensor_algebra - Tests de algebra tensorial (GEMM, tensores)\n";
     std::cout << "show_help         - Mostrar panel de ayuda\n";
     std::cout << "===========================================\n";
     return 0;
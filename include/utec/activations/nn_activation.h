@@ -10,24 +10,46 @@ namespace utec::neural_network {
     template<typename T, size_t Rank>
     using Tensor = utec::algebra::Tensor<T, Rank>;
 
+    // activate / derivative son la versión elemento a elemento que usa FusedDense;
+    // la derivada se expresa con la salida y = f(z), que es lo que guarda la capa fusionada
     template<typename T>
     struct ReLU final : ILayer<T> {
         Tensor<T,2> last_input_;
 
-        Tensor<T,2> forward(const Tensor<T,2>& x) override {
-            last_input_ = x;
+        static T activate(T z) { return z > T(0) ? z : T(0); }
+        static T derivative(T y) { return y > T(0) ? T(1) : T(0); }
+
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<ReLU>(*this); }
+
+        Tensor<T,2> forward(TensorView<const T,2> x) override {
+            Tensor<T,2> out(0, 0);
+            forward_into(x, out);
+            return out;
+        }
+
+        Tensor<T,2> backward(TensorView<const T,2> grad) override {
+            Tensor<T,2> out(0, 0);
+            backward_into(grad, out);
+            return out;
+        }
+
+        void forward_into(TensorView<const T,2> x, Tensor<T,2>& out) override {
+            utec::algebra::materialize(x, last_input_);
+            forward_inference(x, out);
+        }
+
+        void forward_inference(TensorView<const T,2> x, Tensor<T,2>& out) const override {
             auto s = x.shape();
-            Tensor<T,2> out(s[0], s[1]);
+            out.reshape(s);
 
             for (size_t i = 0; i < s[0]; ++i)
                 for (size_t j = 0; j < s[1]; ++j)
                     out(i,j) = x(i,j) > T(0) ? x(i,j) : T(0);
-            return out;
         }
 
-        Tensor<T,2> backward(const Tensor<T,2>& grad) override {
+        void backward_into(TensorView<const T,2> grad, Tensor<T,2>& out) override {
             auto s = grad.shape();
-            Tensor<T,2> out(s[0], s[1]);
+            out.reshape(s);
 
             for (size_t i = 0; i < s[0]; ++i)
                 for (size_t j = 0; j < s[1]; ++j)
@@ -37,7 +59,6 @@ namespace utec::neural_network {
                 for (size_t j = 0; j < s[1]; ++j)
                     if (last_input_(i,j) <= T(0))
                         out(i,j) = T(0);
-            return out;
         }
     };
 
@@ -45,31 +66,50 @@ namespace utec::neural_network {
     struct Sigmoid final : ILayer<T> {
         Tensor<T,2> last_output_;
 
-        Tensor<T,2> forward(const Tensor<T,2>& x) override {
+        static T activate(T z) {
+            if (z > T(500))  z = T(500);
+            if (z < T(-500)) z = T(-500);
+            return T(1)/(T(1) + std::exp(-z));
+        }
+        static T derivative(T y) { return y * (T(1) - y); }
+
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Sigmoid>(*this); }
+
+        Tensor<T,2> forward(TensorView<const T,2> x) override {
+            Tensor<T,2> out(0, 0);
+            forward_into(x, out);
+            return out;
+        }
+
+        Tensor<T,2> backward(TensorView<const T,2> grad) override {
+            Tensor<T,2> out(0, 0);
+            backward_into(grad, out);
+            return out;
+        }
+
+        void forward_into(TensorView<const T,2> x, Tensor<T,2>& out) override {
+            forward_inference(x, out);
+            last_output_ = out;
+        }
+
+        void forward_inference(TensorView<const T,2> x, Tensor<T,2>& out) const override {
             auto s = x.shape();
-            Tensor<T,2> out(s[0], s[1]);
+            out.reshape(s);
 
             for (size_t i = 0; i < s[0]; ++i)
-                for (size_t j = 0; j < s[1]; ++j) {
-                    T v = x(i,j);
-                    if (v > T(500))  v = T(500);
-                    if (v < T(-500)) v = T(-500);
-                    out(i,j) = T(1)/(T(1) + std::exp(-v));
-                }
-            last_output_ = out;
-            return out;
+                for (size_t j = 0; j < s[1]; ++j)
+                    out(i,j) = activate(x(i,j));
         }
 
-        Tensor<T,2> backward(const Tensor<T,2>& grad) override {
+        void backward_into(TensorView<const T,2> grad, Tensor<T,2>& out) override {
             auto s = grad.shape();
-            Tensor<T,2> out(s[0], s[1]);
+            out.reshape(s);
 
             for (size_t i = 0; i < s[0]; ++i)
                 for (size_t j = 0; j < s[1]; ++j) {
                     T y = last_output_(i,j);
                     out(i,j) = grad(i,j) * y * (T(1) - y);
                 }
-            return out;
         }
     };
 
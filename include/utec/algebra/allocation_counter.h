@@ -0,0 +1,118 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_ALLOCATION_COUNTER_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Contador de reservas de memoria dinámica del proceso.
+// Las funciones de conteo están siempre disponibles; para que cuenten algo, exactamente
+// una unidad de traducción del ejecutable debe definir UTEC_COUNT_ALLOCATIONS antes de
+// incluir este archivo: así reemplaza los operator new / delete globales, por los que
+// pasan Tensor, std::vector y el resto de contenedores.
+namespace utec::algebra {
+
+    struct AllocationStats {
+        size_t allocations = 0;
+        size_t deallocations = 0;
+        size_t bytes = 0;
+    };
+
+    namespace detail {
+
+        struct AllocationCounters {
+            std::atomic<size_t> allocations{0};
+            std::atomic<size_t> deallocations{0};
+            std::atomic<size_t> bytes{0};
+            std::atomic<bool> installed{false};
+        };
+
+        inline AllocationCounters& allocation_counters() noexcept {
+            static AllocationCounters counters;
+            return counters;
+        }
+
+        inline void* counted_allocate(size_t bytes, size_t alignment) {
+            auto& c = allocation_counters();
+            c.allocations.fetch_add(1, std::memory_order_relaxed);
+            c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            if (bytes == 0) bytes = 1;
+            void* p = alignment <= alignof(std::max_align_t)
+                ? std::malloc(bytes)
+                : std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+            if (!p) throw std::bad_alloc();
+            return p;
+        }
+
+        inline void counted_free(void* p) noexcept {
+            if (!p) return;
+            allocation_counters().deallocations.fetch_add(1, std::memory_order_relaxed);
+            std::free(p);
+        }
+
+    }
+
+    // true si este ejecutable reemplazó operator new con UTEC_COUNT_ALLOCATIONS
+    inline bool allocation_counting_enabled() noexcept {
+        return detail::allocation_counters().installed.load(std::memory_order_relaxed);
+    }
+
+    inline AllocationStats allocation_stats() noexcept {
+        auto& c = detail::allocation_counters();
+        return {c.allocations.load(std::memory_order_relaxed),
+                c.deallocations.load(std::memory_order_relaxed),
+                c.bytes.load(std::memory_order_relaxed)};
+    }
+
+    // Reservas hechas desde su construcción (en todos los hilos)
+    class AllocationScope {
+        AllocationStats start_ = allocation_stats();
+
+    public:
+        AllocationStats stats() const noexcept {
+            const AllocationStats now = allocation_stats();
+            return {now.allocations - start_.allocations,
+                    now.deallocations - start_.deallocations,
+                    now.bytes - start_.bytes};
+        }
+
+        size_t allocations() const noexcept { return stats().allocations; }
+    };
+
+}
+
+#ifdef UTEC_COUNT_ALLOCATIONS
+
+static const bool utec_allocation_counter_installed = [] {
+    utec::algebra::detail::allocation_counters().installed.store(true, std::memory_order_relaxed);
+    return true;
+}();
+
+void* operator new(size_t n) { return utec::algebra::detail::counted_allocate(n, 0); }
+void* operator new[](size_t n) { return utec::algebra::detail::counted_allocate(n, 0); }
+void* operator new(size_t n, std::align_val_t a) {
+    return utec::algebra::detail::counted_allocate(n, static_cast<size_t>(a));
+}
+void* operator new[](size_t n, std::align_val_t a) {
+    return utec::algebra::detail::counted_allocate(n, static_cast<size_t>(a));
+}
+void* operator new(size_t n, const std::nothrow_t&) noexcept {
+    try { return utec::algebra::detail::counted_allocate(n, 0); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t n, const std::nothrow_t&) noexcept {
+    try { return utec::algebra::detail::counted_allocate(n, 0); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { utec::algebra::detail::counted_free(p); }
+void operator delete[](void* p) noexcept { utec::algebra::detail::counted_free(p); }
+void operator delete(void* p, size_t) noexcept { utec::algebra::detail::counted_free(p); }
+void operator delete[](void* p, size_t) noexcept { utec::algebra::detail::counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { utec::algebra::detail::counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { utec::algebra::detail::counted_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { utec::algebra::detail::counted_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { utec::algebra::detail::counted_free(p); }
+
+#endif
+
+#endif // PROG3_TENSOR_FINAL_PROJECT_V2025_01_ALLOCATION_COUNTER_H
@@ -0,0 +1,581 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_GEMM_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_GEMM_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include "half.h"
+#include "tensor_storage.h"
+#include "thread_pool.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define UTEC_GEMM_X86 1
+#include <immintrin.h>
+#endif
+
+// Motor GEMM: C(m x n) = A(m x k) * B(k x n) sobre memoria row-major.
+// Sigue el esquema clasico de Goto/BLIS: bloques NC x KC de B y MC x KC de A
+// se empaquetan en paneles contiguos (caben en L2/L1) y un micro-kernel
+// MR x NR acumula la tesela completa en registros.
+// Con bf16 / fp16 los paneles se convierten a float al empaquetar y se acumula en float.
+namespace utec::algebra {
+
+    enum class GemmIsa { Scalar, AVX2, AVX512 };
+
+    namespace detail {
+
+        template<typename T>
+        using MicroKernelFn = void (*)(size_t kc, const T* a, const T* b,
+                                       T* c, size_t ldc, bool accumulate);
+
+        template<typename T>
+        struct GemmKernel {
+            MicroKernelFn<T> fn;
+            size_t mr, nr;
+            size_t mc, kc, nc;
+        };
+
+        // Micro-kernel portable: el compilador puede vectorizar el bucle en j
+        template<typename T, size_t MR, size_t NR>
+        void micro_kernel_generic(size_t kc, const T* a, const T* b,
+                                  T* c, size_t ldc, bool accumulate) {
+            T acc[MR][NR] = {};
+            for (size_t p = 0; p < kc; ++p) {
+                for (size_t i = 0; i < MR; ++i) {
+                    const T ai = a[p * MR + i];
+                    for (size_t j = 0; j < NR; ++j)
+                        acc[i][j] += ai * b[p * NR + j];
+                }
+            }
+            for (size_t i = 0; i < MR; ++i)
+                for (size_t j = 0; j < NR; ++j)
+                    c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j];
+        }
+
+#ifdef UTEC_GEMM_X86
+        __attribute__((target("avx2,fma")))
+        inline void micro_kernel_avx2_6x16(size_t kc, const float* a, const float* b,
+                                           float* c, size_t ldc, bool accumulate) {
+            __m256 acc[6][2];
+#pragma GCC unroll 6
+            for (int i = 0; i < 6; ++i) {
+                acc[i][0] = _mm256_setzero_ps();
+                acc[i][1] = _mm256_setzero_ps();
+            }
+            // Los paneles de B empaquetados empiezan en múltiplos de 64 bytes
+            for (size_t p = 0; p < kc; ++p) {
+                const __m256 b0 = _mm256_load_ps(b);
+                const __m256 b1 = _mm256_load_ps(b + 8);
+#pragma GCC unroll 6
+                for (int i = 0; i < 6; ++i) {
+                    const __m256 ai = _mm256_broadcast_ss(a + i);
+                    acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+                    acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+                }
+                a += 6;
+                b += 16;
+            }
+#pragma GCC unroll 6
+            for (int i = 0; i < 6; ++i) {
+                float* row = c + i * ldc;
+                if (accumulate) {
+                    acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(row));
+                    acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(row + 8));
+                }
+                _mm256_storeu_ps(row, acc[i][0]);
+                _mm256_storeu_ps(row + 8, acc[i][1]);
+            }
+        }
+
+        __attribute__((target("avx512f")))
+        inline void micro_kernel_avx512_8x32(size_t kc, const float* a, const float* b,
+                                             float* c, size_t ldc, bool accumulate) {
+            __m512 acc[8][2];
+#pragma GCC unroll 8
+            for (int i = 0; i < 8; ++i) {
+                acc[i][0] = _mm512_setzero_ps();
+                acc[i][1] = _mm512_setzero_ps();
+            }
+            for (size_t p = 0; p < kc; ++p) {
+                const __m512 b0 = _mm512_load_ps(b);
+                const __m512 b1 = _mm512_load_ps(b + 16);
+#pragma GCC unroll 8
+                for (int i = 0; i < 8; ++i) {
+                    const __m512 ai = _mm512_set1_ps(a[i]);
+                    acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+                    acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+                }
+                a += 8;
+                b += 32;
+            }
+#pragma GCC unroll 8
+            for (int i = 0; i < 8; ++i) {
+                float* row = c + i * ldc;
+                if (accumulate) {
+                    acc[i][0] = _mm512_add_ps(acc[i][0], _mm512_loadu_ps(row));
+                    acc[i][1] = _mm512_add_ps(acc[i][1], _mm512_loadu_ps(row + 16));
+                }
+                _mm512_storeu_ps(row, acc[i][0]);
+                _mm512_storeu_ps(row + 16, acc[i][1]);
+            }
+        }
+#endif
+
+        inline bool isa_supported(GemmIsa isa) {
+#ifdef UTEC_GEMM_X86
+            switch (isa) {
+                case GemmIsa::AVX512: return __builtin_cpu_supports("avx512f");
+                case GemmIsa::AVX2:   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+                default:              return true;
+            }
+#else
+            return isa == GemmIsa::Scalar;
+#endif
+        }
+
+        inline GemmIsa detect_isa() {
+            if (isa_supported(GemmIsa::AVX512)) return GemmIsa::AVX512;
+            if (isa_supported(GemmIsa::AVX2)) return GemmIsa::AVX2;
+            return GemmIsa::Scalar;
+        }
+
+        inline std::atomic<GemmIsa>& active_isa() {
+            static std::atomic<GemmIsa> isa{detect_isa()};
+            return isa;
+        }
+
+        template<typename T>
+        GemmKernel<T> select_kernel() {
+            return {&micro_kernel_generic<T, 4, 8>, 4, 8, 64, 256, 2048};
+        }
+
+        template<>
+        inline GemmKernel<float> select_kernel<float>() {
+#ifdef UTEC_GEMM_X86
+            switch (active_isa().load(std::memory_order_relaxed)) {
+                case GemmIsa::AVX512: return {&micro_kernel_avx512_8x32, 8, 32, 96, 256, 2048};
+                case GemmIsa::AVX2:   return {&micro_kernel_avx2_6x16, 6, 16, 96, 256, 2048};
+                default: break;
+            }
+#endif
+            return {&micro_kernel_generic<float, 4, 8>, 4, 8, 64, 256, 2048};
+        }
+
+        // Operando de solo lectura con pasos arbitrarios: elemento (i, j) = ptr[i * rs + j * cs].
+        // Una matriz transpuesta es la misma memoria con rs y cs intercambiados.
+        // ri / ci (opcionales) indirectan filas o columnas, asi un gather se resuelve al empaquetar.
+        template<typename T>
+        struct StridedMatrix {
+            const T* ptr;
+            size_t rs, cs;
+            const size_t* ri = nullptr;
+            const size_t* ci = nullptr;
+
+            const T& operator()(size_t i, size_t j) const {
+                return ptr[(ri ? ri[i] : i) * rs + (ci ? ci[j] : j) * cs];
+            }
+
+            StridedMatrix block(size_t i, size_t j) const {
+                return {ptr + (ri ? 0 : i * rs) + (ci ? 0 : j * cs), rs, cs,
+                        ri ? ri + i : nullptr, ci ? ci + j : nullptr};
+            }
+        };
+
+        // Copia contigua al panel, convirtiendo si el panel es de otro tipo
+        template<typename T, typename U>
+        void pack_copy(const T* src, size_t n, U* dst) {
+            if constexpr (std::is_same_v<T, U>) std::copy(src, src + n, dst);
+            else convert(src, dst, n);
+        }
+
+        // Panel de A: bloques de MR filas, cada uno guardado como kc columnas de MR valores
+        template<typename T, typename U>
+        void pack_a(size_t mc, size_t kc, StridedMatrix<T> a, size_t mr, U* dst) {
+            for (size_t ir = 0; ir < mc; ir += mr) {
+                const size_t rows = std::min(mr, mc - ir);
+                for (size_t p = 0; p < kc; ++p) {
+                    if (a.rs == 1 && !a.ri) {
+                        // A transpuesta: las MR filas de la columna p son contiguas
+                        pack_copy(&a(ir, p), rows, dst);
+                    } else {
+                        for (size_t r = 0; r < rows; ++r)
+                            dst[r] = a(ir + r, p);
+                    }
+                    std::fill(dst + rows, dst + mr, U{});
+                    dst += mr;
+                }
+            }
+        }
+
+        // Panel de B: bloques de NR columnas, cada uno guardado como kc filas de NR valores
+        template<typename T, typename U>
+        void pack_b(size_t kc, size_t nc, StridedMatrix<T> b, size_t nr, U* dst) {
+            for (size_t jr = 0; jr < nc; jr += nr) {
+                const size_t cols = std::min(nr, nc - jr);
+                for (size_t p = 0; p < kc; ++p) {
+                    if (b.cs == 1 && !b.ci) {
+                        pack_copy(&b(p, jr), cols, dst);
+                    } else {
+                        for (size_t j = 0; j < cols; ++j)
+                            dst[j] = b(p, jr + j);
+                    }
+                    std::fill(dst + cols, dst + nr, U{});
+                    dst += nr;
+                }
+            }
+        }
+
+        // Epílogo vacío: el GEMM solo escribe C
+        struct NoEpilogue {
+            template<typename C>
+            void operator()(size_t, size_t, C*, size_t) const noexcept {}
+        };
+
+        template<typename Ep>
+        inline constexpr bool has_epilogue = !std::is_same_v<Ep, NoEpilogue>;
+
+        // Con epílogo (last = último bloque de k), cada tesela terminada se pasa fila a fila
+        // a ep(i, j, &C(i, j), cols) mientras sigue en L1; (i0, j0) es su origen en C
+        template<typename T, typename Ep = NoEpilogue>
+        void macro_kernel(const GemmKernel<T>& k, size_t mc, size_t nc, size_t kc,
+                          const T* a_packed, const T* b_packed,
+                          T* c, size_t ldc, bool accumulate,
+                          const Ep& ep = {}, bool last = false, size_t i0 = 0, size_t j0 = 0) {
+            alignas(default_alignment) T edge[32 * 32];
+            for (size_t jr = 0; jr < nc; jr += k.nr) {
+                const size_t cols = std::min(k.nr, nc - jr);
+                const T* b_panel = b_packed + jr * kc;
+                for (size_t ir = 0; ir < mc; ir += k.mr) {
+                    const size_t rows = std::min(k.mr, mc - ir);
+                    const T* a_panel = a_packed + ir * kc;
+                    T* c_tile = c + ir * ldc + jr;
+                    if (rows == k.mr && cols == k.nr) {
+                        k.fn(kc, a_panel, b_panel, c_tile, ldc, accumulate);
+                    } else {
+                        // Tesela de borde: se calcula completa en un buffer local
+                        k.fn(kc, a_panel, b_panel, edge, k.nr, false);
+                        for (size_t i = 0; i < rows; ++i)
+                            for (size_t j = 0; j < cols; ++j)
+                                c_tile[i * ldc + j] = accumulate ? c_tile[i * ldc + j] + edge[i * k.nr + j]
+                                                                 : edge[i * k.nr + j];
+                    }
+                    if constexpr (has_epilogue<Ep>) {
+                        if (last)
+                            for (size_t i = 0; i < rows; ++i)
+                                ep(i0 + ir + i, j0 + jr, c_tile + i * ldc, cols);
+                    }
+                }
+            }
+        }
+
+        // Problemas muy pequenos: el empaquetado cuesta mas que lo que ahorra
+        template<typename T, typename C, typename Ep = NoEpilogue>
+        void gemm_small(size_t m, size_t n, size_t k, StridedMatrix<T> a, StridedMatrix<T> b,
+                        C* c, size_t ldc, bool accumulate, const Ep& ep = {}) {
+            for (size_t i = 0; i < m; ++i) {
+                C* c_row = c + i * ldc;
+                if (b.cs == 1 && !b.ci) {
+                    if (!accumulate) std::fill(c_row, c_row + n, C{});
+                    for (size_t p = 0; p < k; ++p) {
+                        const C a_ip = a(i, p);
+                        const T* b_row = &b(p, 0);
+                        for (size_t j = 0; j < n; ++j)
+                            c_row[j] += a_ip * b_row[j];
+                    }
+                } else {
+                    // B transpuesta: cada C(i, j) es un producto punto sobre memoria contigua
+                    for (size_t j = 0; j < n; ++j) {
+                        C sum = accumulate ? c_row[j] : C{};
+                        for (size_t p = 0; p < k; ++p)
+                            sum += a(i, p) * b(p, j);
+                        c_row[j] = sum;
+                    }
+                }
+                ep(i, 0, c_row, n);
+            }
+        }
+
+        inline constexpr size_t gemm_small_threshold = 16 * 16 * 16;
+
+        // Trabajo mínimo (m·n·k) por hilo para que compense despertar al pool
+        inline constexpr size_t gemm_min_work_per_thread = 64 * 64 * 64;
+
+    }
+
+    inline GemmIsa gemm_isa() {
+        return detail::active_isa().load(std::memory_order_relaxed);
+    }
+
+    // Fuerza un set de instrucciones (p.ej. para pruebas); devuelve false si el CPU no lo soporta
+    inline bool set_gemm_isa(GemmIsa isa) {
+        if (!detail::isa_supported(isa)) return false;
+        detail::active_isa().store(isa, std::memory_order_relaxed);
+        return true;
+    }
+
+    inline const char* gemm_isa_name(GemmIsa isa) {
+        switch (isa) {
+            case GemmIsa::AVX512: return "AVX-512";
+            case GemmIsa::AVX2:   return "AVX2";
+            default:              return "Scalar";
+        }
+    }
+
+    namespace detail {
+
+        // C (de tipo accumulator_t<T>) = A * B en un solo hilo; A y B se convierten al empaquetar.
+        // El epílogo recibe filas de C en el tipo acumulador, antes de redondear a T.
+        template<typename T, typename C, typename Ep = NoEpilogue>
+        void gemm_serial_acc(size_t m, size_t n, size_t k,
+                             StridedMatrix<T> a, StridedMatrix<T> b,
+                             C* c, size_t ldc, bool accumulate, const Ep& ep = {}) {
+            if (k == 0) {
+                for (size_t i = 0; i < m; ++i) {
+                    if (!accumulate) std::fill(c + i * ldc, c + i * ldc + n, C{});
+                    ep(i, 0, c + i * ldc, n);
+                }
+                return;
+            }
+            if (m * n * k <= gemm_small_threshold) {
+                gemm_small(m, n, k, a, b, c, ldc, accumulate, ep);
+                return;
+            }
+
+            const GemmKernel<C> kern = select_kernel<C>();
+            thread_local std::vector<C, AlignedAllocator<C>> a_buf, b_buf;
+
+            const size_t nc_max = std::min(kern.nc, n);
+            const size_t kc_max = std::min(kern.kc, k);
+            const size_t mc_max = std::min(kern.mc, m);
+            const size_t b_len = kc_max * ((nc_max + kern.nr - 1) / kern.nr) * kern.nr;
+            const size_t a_len = kc_max * ((mc_max + kern.mr - 1) / kern.mr) * kern.mr;
+            if (b_buf.size() < b_len) b_buf.resize(b_len);
+            if (a_buf.size() < a_len) a_buf.resize(a_len);
+
+            for (size_t jc = 0; jc < n; jc += kern.nc) {
+                const size_t nc = std::min(kern.nc, n - jc);
+                for (size_t pc = 0; pc < k; pc += kern.kc) {
+                    const size_t kc = std::min(kern.kc, k - pc);
+                    const bool acc = accumulate || pc > 0;
+                    pack_b(kc, nc, b.block(pc, jc), kern.nr, b_buf.data());
+                    for (size_t ic = 0; ic < m; ic += kern.mc) {
+                        const size_t mc = std::min(kern.mc, m - ic);
+                        pack_a(mc, kc, a.block(ic, pc), kern.mr, a_buf.data());
+                        macro_kernel(kern, mc, nc, kc, a_buf.data(), b_buf.data(),
+                                     c + ic * ldc + jc, ldc, acc, ep, pc + kc == k, ic, jc);
+                    }
+                }
+            }
+        }
+
+        template<typename T, typename Ep = NoEpilogue>
+        void gemm_serial(size_t m, size_t n, size_t k,
+                         StridedMatrix<T> a, StridedMatrix<T> b,
+                         T* c, size_t ldc, bool accumulate, const Ep& ep = {}) {
+            if (m == 0 || n == 0) return;
+            using Acc = accumulator_t<T>;
+            if constexpr (std::is_same_v<T, Acc>) {
+                gemm_serial_acc(m, n, k, a, b, c, ldc, accumulate, ep);
+            } else {
+                // C se acumula completa en float y se redondea una sola vez al final
+                thread_local std::vector<Acc, AlignedAllocator<Acc>> c_buf;
+                if (c_buf.size() < m * n) c_buf.resize(m * n);
+                if (accumulate)
+                    for (size_t i = 0; i < m; ++i) convert(c + i * ldc, c_buf.data() + i * n, n);
+                gemm_serial_acc(m, n, k, a, b, c_buf.data(), n, accumulate, ep);
+                for (size_t i = 0; i < m; ++i) convert(c_buf.data() + i * n, c + i * ldc, n);
+            }
+        }
+
+        // Rejilla mt x nt (mt * nt = tasks) que minimiza tile_m + tile_n,
+        // es decir, lo que cada hilo empaqueta de A y de B
+        inline void gemm_grid(size_t m, size_t n, size_t tasks, size_t& mt, size_t& nt) {
+            mt = 1;
+            nt = tasks;
+            size_t best = static_cast<size_t>(-1);
+            for (size_t d = 1; d <= tasks; ++d) {
+                if (tasks % d != 0) continue;
+                const size_t cost = (m + d - 1) / d + (n + tasks / d - 1) / (tasks / d);
+                if (cost < best) {
+                    best = cost;
+                    mt = d;
+                    nt = tasks / d;
+                }
+            }
+        }
+
+        // Reparte C en teselas 2D sobre M y N entre los hilos del pool; cada tesela
+        // es un GEMM serie independiente con sus propios paneles empaquetados.
+        // Problemas pequeños o llamadas desde una tarea del pool se quedan en un hilo.
+        // ep(i, j, fila, cols) ve cada fila de C ya completa (coordenadas globales).
+        template<typename T, typename Ep = NoEpilogue>
+        void gemm_strided(size_t m, size_t n, size_t k,
+                          StridedMatrix<T> a, StridedMatrix<T> b,
+                          T* c, size_t ldc, bool accumulate, const Ep& ep = {}) {
+            ThreadPool& pool = thread_pool();
+            const size_t tasks = std::min(pool.size(), m * n * k / gemm_min_work_per_thread);
+            if (tasks <= 1 || ThreadPool::on_worker_thread()) {
+                gemm_serial(m, n, k, a, b, c, ldc, accumulate, ep);
+                return;
+            }
+
+            const GemmKernel<accumulator_t<T>> kern = select_kernel<accumulator_t<T>>();
+            size_t mt, nt;
+            gemm_grid(m, n, tasks, mt, nt);
+            // Teselas múltiplo de MR x NR: solo los bordes de C pasan por el buffer de borde
+            const size_t tile_m = ((m + mt - 1) / mt + kern.mr - 1) / kern.mr * kern.mr;
+            const size_t tile_n = ((n + nt - 1) / nt + kern.nr - 1) / kern.nr * kern.nr;
+            mt = (m + tile_m - 1) / tile_m;
+            nt = (n + tile_n - 1) / tile_n;
+
+            pool.parallel_for(mt * nt, [&](size_t t) {
+                const size_t i0 = (t / nt) * tile_m;
+                const size_t j0 = (t % nt) * tile_n;
+                auto tile_ep = [&ep, i0, j0](size_t i, size_t j, auto* row, size_t cols) {
+                    ep(i0 + i, j0 + j, row, cols);
+                };
+                gemm_serial(std::min(tile_m, m - i0), std::min(tile_n, n - j0), k,
+                            a.block(i0, 0), b.block(0, j0), c + i0 * ldc + j0, ldc, accumulate,
+                            tile_ep);
+            });
+        }
+
+        // Lote de problemas independientes C_i = A_i * B_i; un paso 0 comparte el operando
+        // entre todos (p. ej. los mismos pesos para varias entradas).
+        template<typename T>
+        void gemm_batched_strided(size_t batch, size_t m, size_t n, size_t k,
+                                  StridedMatrix<T> a, size_t stride_a,
+                                  StridedMatrix<T> b, size_t stride_b,
+                                  T* c, size_t ldc, size_t stride_c, bool accumulate) {
+            auto item = [&](size_t i, auto run) {
+                run(m, n, k, StridedMatrix<T>{a.ptr + i * stride_a, a.rs, a.cs, a.ri, a.ci},
+                    StridedMatrix<T>{b.ptr + i * stride_b, b.rs, b.cs, b.ri, b.ci},
+                    c + i * stride_c, ldc, accumulate);
+            };
+            ThreadPool& pool = thread_pool();
+            const size_t work = m * n * k;
+            // Pocos problemas grandes: se reparte cada uno en teselas, de a uno
+            if (batch < pool.size() && work >= 2 * gemm_min_work_per_thread) {
+                for (size_t i = 0; i < batch; ++i) item(i, [](auto... args) { gemm_strided<T>(args...); });
+                return;
+            }
+            // Muchos problemas o problemas pequeños: una tarea por matriz del lote
+            if (batch * work < gemm_min_work_per_thread) {
+                for (size_t i = 0; i < batch; ++i) item(i, [](auto... args) { gemm_serial<T>(args...); });
+                return;
+            }
+            pool.parallel_for(batch, [&](size_t i) { item(i, [](auto... args) { gemm_serial<T>(args...); }); });
+        }
+
+    }
+
+    // --- Epílogos y prólogos de capas densas ------------------------------------------------
+    // GCC convierte los `v > 0 ? v : 0` de un bucle en saltos (mal predichos con signos
+    // aleatorios); con AVX2 se usan max / cmp + and, sin ramas.
+
+    namespace detail {
+
+#ifdef UTEC_GEMM_X86
+        __attribute__((target("avx2")))
+        inline size_t add_bias_avx2(float* row, const float* bias, size_t n, bool relu, float* copy) {
+            const __m256 zero = _mm256_setzero_ps();
+            size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                __m256 y = _mm256_add_ps(_mm256_loadu_ps(row + j), _mm256_loadu_ps(bias + j));
+                if (relu) y = _mm256_max_ps(y, zero);
+                _mm256_storeu_ps(row + j, y);
+                if (copy) _mm256_storeu_ps(copy + j, y);
+            }
+            return j;
+        }
+
+        __attribute__((target("avx2")))
+        inline size_t relu_grad_avx2(const float* grad, const float* y, size_t n, float* dz, float* sum) {
+            const __m256 zero = _mm256_setzero_ps();
+            size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                const __m256 mask = _mm256_cmp_ps(_mm256_loadu_ps(y + j), zero, _CMP_GT_OQ);
+                const __m256 d = _mm256_and_ps(_mm256_loadu_ps(grad + j), mask);
+                _mm256_storeu_ps(dz + j, d);
+                _mm256_storeu_ps(sum + j, _mm256_add_ps(_mm256_loadu_ps(sum + j), d));
+            }
+            return j;
+        }
+#endif
+
+    }
+
+    // row = row + bias (ReLU opcional) sobre n valores; si copy no es nulo también se escribe ahí
+    inline void add_bias(float* row, const float* bias, size_t n, bool relu = false, float* copy = nullptr) {
+        size_t j = 0;
+#ifdef UTEC_GEMM_X86
+        if (gemm_isa() != GemmIsa::Scalar) j = detail::add_bias_avx2(row, bias, n, relu, copy);
+#endif
+        for (; j < n; ++j) {
+            float y = row[j] + bias[j];
+            if (relu && y < 0.0f) y = 0.0f;
+            row[j] = y;
+            if (copy) copy[j] = y;
+        }
+    }
+
+    // Gradiente a través de una ReLU con salida y: dz = grad si y > 0, si no 0; sum += dz
+    inline void relu_grad(const float* grad, const float* y, size_t n, float* dz, float* sum) {
+        size_t j = 0;
+#ifdef UTEC_GEMM_X86
+        if (gemm_isa() != GemmIsa::Scalar) j = detail::relu_grad_avx2(grad, y, n, dz, sum);
+#endif
+        for (; j < n; ++j) {
+            const float d = y[j] > 0.0f ? grad[j] : 0.0f;
+            dz[j] = d;
+            sum[j] += d;
+        }
+    }
+
+    // C = A * B (o C += A * B si accumulate). lda/ldb/ldc son los pasos entre filas.
+    template<typename T>
+    void gemm(size_t m, size_t n, size_t k,
+              const T* a, size_t lda,
+              const T* b, size_t ldb,
+              T* c, size_t ldc,
+              bool accumulate = false) {
+        detail::gemm_strided<T>(m, n, k, {a, lda, 1}, {b, ldb, 1}, c, ldc, accumulate);
+    }
+
+    // C_i = A_i * B_i para i en [0, batch); stride_* es la distancia entre matrices
+    // consecutivas del lote (0 para usar la misma matriz en todos los problemas).
+    template<typename T>
+    void gemm_batched(size_t batch, size_t m, size_t n, size_t k,
+                      const T* a, size_t lda, size_t stride_a,
+                      const T* b, size_t ldb, size_t stride_b,
+                      T* c, size_t ldc, size_t stride_c,
+                      bool accumulate = false) {
+        detail::gemm_batched_strided<T>(batch, m, n, k, {a, lda, 1}, stride_a, {b, ldb, 1}, stride_b,
+                                        c, ldc, stride_c, accumulate);
+    }
+
+    // C = A^T * B, con A guardada como (k x m). No se materializa la transpuesta.
+    template<typename T>
+    void gemm_tn(size_t m, size_t n, size_t k,
+                 const T* a, size_t lda,
+                 const T* b, size_t ldb,
+                 T* c, size_t ldc,
+                 bool accumulate = false) {
+        detail::gemm_strided<T>(m, n, k, {a, 1, lda}, {b, ldb, 1}, c, ldc, accumulate);
+    }
+
+    // C = A * B^T, con B guardada como (n x k). No se materializa la transpuesta.
+    template<typename T>
+    void gemm_nt(size_t m, size_t n, size_t k,
+                 const T* a, size_t lda,
+                 const T* b, size_t ldb,
+                 T* c, size_t ldc,
+                 bool accumulate = false) {
+        detail::gemm_strided<T>(m, n, k, {a, lda, 1}, {b, 1, ldb}, c, ldc, accumulate);
+    }
+
+}
+
+#endif //PROG3_TENSOR_FINAL_PROJECT_V2025_01_GEMM_H
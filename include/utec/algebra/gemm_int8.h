@@ -0,0 +1,305 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_GEMM_INT8_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_GEMM_INT8_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "gemm.h"
+#include "tensor_storage.h"
+
+// GEMM entero para inferencia cuantizada: C(m x n, int32) = A(m x k, uint8) * B(k x n, int8).
+// B se reordena una vez en grupos de 4 filas de k por columna, el formato que consumen
+// vpdpbusd (AVX-512 VNNI) y vpmaddubsw + vpmaddwd (AVX2). Las activaciones se limitan
+// a [0, 127]: así la suma de pares en int16 de maddubs nunca satura y todos los
+// caminos dan exactamente el mismo resultado.
+namespace utec::algebra {
+
+    inline constexpr int32_t int8_activation_max = 127;
+    inline constexpr int32_t int8_weight_max = 127;
+
+    // B empaquetado: data[(p * n_pad + j) * 4 + r] = B(4p + r, j), con ceros de relleno
+    struct PackedInt8Matrix {
+        size_t k = 0, n = 0, k4 = 0, n_pad = 0;
+        std::vector<int8_t, AlignedAllocator<int8_t>> data;
+        std::vector<int32_t> col_sums;   // sum_k B(k, j), para corregir el punto cero de A
+
+        // Bytes que debe poder leerse de cada fila de A (k redondeado a 4)
+        size_t padded_k() const noexcept { return k4 * 4; }
+    };
+
+    inline PackedInt8Matrix pack_int8(const int8_t* b, size_t k, size_t n, size_t ldb) {
+        PackedInt8Matrix p;
+        p.k = k;
+        p.n = n;
+        p.k4 = (k + 3) / 4;
+        p.n_pad = (n + 15) / 16 * 16;
+        p.data.assign(p.k4 * p.n_pad * 4, 0);
+        p.col_sums.assign(n, 0);
+        for (size_t kk = 0; kk < k; ++kk)
+            for (size_t j = 0; j < n; ++j) {
+                const int8_t v = b[kk * ldb + j];
+                p.data[((kk / 4) * p.n_pad + j) * 4 + kk % 4] = v;
+                p.col_sums[j] += v;
+            }
+        return p;
+    }
+
+    namespace detail {
+
+        // Tesela MR x (NV vectores) en escalar, sobre el mismo formato empaquetado
+        inline void int8_tile_scalar(size_t rows, size_t j0, size_t cols, const uint8_t* a, size_t lda,
+                                     const PackedInt8Matrix& b, int32_t* c, size_t ldc) {
+            for (size_t i = 0; i < rows; ++i) {
+                int32_t* ci = c + i * ldc + j0;
+                std::fill(ci, ci + cols, 0);
+                const uint8_t* ai = a + i * lda;
+                for (size_t p = 0; p < b.k4; ++p) {
+                    const int8_t* bp = b.data.data() + (p * b.n_pad + j0) * 4;
+                    for (size_t j = 0; j < cols; ++j)
+                        for (size_t r = 0; r < 4; ++r)
+                            ci[j] += int32_t(ai[p * 4 + r]) * int32_t(bp[j * 4 + r]);
+                }
+            }
+        }
+
+#ifdef UTEC_GEMM_X86
+        inline int32_t load_u8x4(const uint8_t* p) {
+            int32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        template<size_t MR, size_t NV>
+        __attribute__((target("avx512f,avx512bw,avx512vnni")))
+        void int8_tile_vnni512(size_t j0, const uint8_t* a, size_t lda,
+                               const PackedInt8Matrix& b, int32_t* c, size_t ldc) {
+            __m512i acc[MR][NV];
+            for (size_t i = 0; i < MR; ++i)
+                for (size_t v = 0; v < NV; ++v) acc[i][v] = _mm512_setzero_si512();
+            const int8_t* bp = b.data.data() + j0 * 4;
+            for (size_t p = 0; p < b.k4; ++p, bp += b.n_pad * 4) {
+                __m512i bv[NV];
+                for (size_t v = 0; v < NV; ++v) bv[v] = _mm512_load_si512(bp + v * 64);
+                for (size_t i = 0; i < MR; ++i) {
+                    const __m512i av = _mm512_set1_epi32(load_u8x4(a + i * lda + p * 4));
+                    for (size_t v = 0; v < NV; ++v) acc[i][v] = _mm512_dpbusd_epi32(acc[i][v], av, bv[v]);
+                }
+            }
+            for (size_t i = 0; i < MR; ++i)
+                for (size_t v = 0; v < NV; ++v)
+                    _mm512_storeu_si512(c + i * ldc + j0 + v * 16, acc[i][v]);
+        }
+
+        template<size_t MR, size_t NV>
+        __attribute__((target("avx2")))
+        void int8_tile_avx2(size_t j0, const uint8_t* a, size_t lda,
+                            const PackedInt8Matrix& b, int32_t* c, size_t ldc) {
+            const __m256i ones = _mm256_set1_epi16(1);
+            __m256i acc[MR][NV];
+            for (size_t i = 0; i < MR; ++i)
+                for (size_t v = 0; v < NV; ++v) acc[i][v] = _mm256_setzero_si256();
+            const int8_t* bp = b.data.data() + j0 * 4;
+            for (size_t p = 0; p < b.k4; ++p, bp += b.n_pad * 4) {
+                __m256i bv[NV];
+                for (size_t v = 0; v < NV; ++v)
+                    bv[v] = _mm256_load_si256(reinterpret_cast<const __m256i*>(bp + v * 32));
+                for (size_t i = 0; i < MR; ++i) {
+                    const __m256i av = _mm256_set1_epi32(load_u8x4(a + i * lda + p * 4));
+                    for (size_t v = 0; v < NV; ++v) {
+                        const __m256i pairs = _mm256_maddubs_epi16(av, bv[v]);
+                        acc[i][v] = _mm256_add_epi32(acc[i][v], _mm256_madd_epi16(pairs, ones));
+                    }
+                }
+            }
+            for (size_t i = 0; i < MR; ++i)
+                for (size_t v = 0; v < NV; ++v)
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + i * ldc + j0 + v * 8), acc[i][v]);
+        }
+
+        // Despacha por número de filas restantes (1..4) con NV fijo
+        template<size_t NV, template<size_t, size_t> class Tile>
+        void int8_rows(size_t rows, size_t j0, const uint8_t* a, size_t lda,
+                       const PackedInt8Matrix& b, int32_t* c, size_t ldc) {
+            switch (rows) {
+                case 4: Tile<4, NV>::run(j0, a, lda, b, c, ldc); break;
+                case 3: Tile<3, NV>::run(j0, a, lda, b, c, ldc); break;
+                case 2: Tile<2, NV>::run(j0, a, lda, b, c, ldc); break;
+                default: Tile<1, NV>::run(j0, a, lda, b, c, ldc); break;
+            }
+        }
+
+        template<size_t MR, size_t NV>
+        struct Vnni512Tile {
+            static void run(size_t j0, const uint8_t* a, size_t lda, const PackedInt8Matrix& b, int32_t* c, size_t ldc) {
+                int8_tile_vnni512<MR, NV>(j0, a, lda, b, c, ldc);
+            }
+        };
+
+        template<size_t MR, size_t NV>
+        struct Avx2Int8Tile {
+            static void run(size_t j0, const uint8_t* a, size_t lda, const PackedInt8Matrix& b, int32_t* c, size_t ldc) {
+                int8_tile_avx2<MR, NV>(j0, a, lda, b, c, ldc);
+            }
+        };
+#endif
+
+        enum class Int8Isa { Scalar, AVX2, VNNI512 };
+
+        // Sigue a gemm_isa(): AVX-512 usa VNNI si existe y si no cae a maddubs
+        inline Int8Isa int8_isa() {
+#ifdef UTEC_GEMM_X86
+            static const bool vnni = __builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512bw");
+            switch (gemm_isa()) {
+                case GemmIsa::AVX512: return vnni ? Int8Isa::VNNI512 : Int8Isa::AVX2;
+                case GemmIsa::AVX2:   return Int8Isa::AVX2;
+                default: break;
+            }
+#endif
+            return Int8Isa::Scalar;
+        }
+
+        // Bloque de hasta 4 filas de C completas (n_pad columnas)
+        inline void gemm_u8s8_rows(Int8Isa isa, size_t rows, const uint8_t* a, size_t lda,
+                                   const PackedInt8Matrix& b, int32_t* c, size_t ldc) {
+#ifdef UTEC_GEMM_X86
+            if (isa == Int8Isa::VNNI512) {
+                size_t j0 = 0;
+                for (; j0 + 64 <= b.n_pad; j0 += 64) int8_rows<4, Vnni512Tile>(rows, j0, a, lda, b, c, ldc);
+                switch ((b.n_pad - j0) / 16) {
+                    case 3: int8_rows<3, Vnni512Tile>(rows, j0, a, lda, b, c, ldc); break;
+                    case 2: int8_rows<2, Vnni512Tile>(rows, j0, a, lda, b, c, ldc); break;
+                    case 1: int8_rows<1, Vnni512Tile>(rows, j0, a, lda, b, c, ldc); break;
+                    default: break;
+                }
+                return;
+            }
+            if (isa == Int8Isa::AVX2) {
+                for (size_t j0 = 0; j0 < b.n_pad; j0 += 16) int8_rows<2, Avx2Int8Tile>(rows, j0, a, lda, b, c, ldc);
+                return;
+            }
+#endif
+            int8_tile_scalar(rows, 0, b.n_pad, a, lda, b, c, ldc);
+        }
+
+    }
+
+    // Recorre A en bloques de 4 filas y entrega cada fila de C (int32, n columnas)
+    // al epílogo mientras sigue en caché: epilogue(i, const int32_t* fila).
+    // Cada fila de A debe poder leerse hasta b.padded_k(); el relleno puede valer cualquier cosa.
+    template<typename Epilogue>
+    void gemm_u8s8(size_t m, const uint8_t* a, size_t lda, const PackedInt8Matrix& b, Epilogue&& epilogue) {
+        constexpr size_t mr = 4;
+        const detail::Int8Isa isa = detail::int8_isa();
+        thread_local std::vector<int32_t, AlignedAllocator<int32_t>> c_buf;
+        if (c_buf.size() < mr * b.n_pad) c_buf.resize(mr * b.n_pad);
+        for (size_t i0 = 0; i0 < m; i0 += mr) {
+            const size_t rows = std::min(mr, m - i0);
+            detail::gemm_u8s8_rows(isa, rows, a + i0 * lda, lda, b, c_buf.data(), b.n_pad);
+            for (size_t r = 0; r < rows; ++r) epilogue(i0 + r, c_buf.data() + r * b.n_pad);
+        }
+    }
+
+    // --- Conversión float <-> cuantizado -------------------------------------------------
+    // Todas redondean al par más cercano (cvtps / nearbyint) y usan fma para coincidir bit a bit.
+
+    namespace detail {
+
+        inline uint8_t saturate_u7(int32_t q, int32_t lo) {
+            return static_cast<uint8_t>(std::clamp(q, lo, int8_activation_max));
+        }
+
+#ifdef UTEC_GEMM_X86
+        // 8 int32 -> 8 uint8 en [lo, 127]
+        __attribute__((target("avx2")))
+        inline void store_u7x8(__m256i q, __m256i lo, uint8_t* out) {
+            q = _mm256_min_epi32(_mm256_max_epi32(q, lo), _mm256_set1_epi32(int8_activation_max));
+            const __m128i w = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(w, w));
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline size_t quantize_avx2(const float* x, size_t n, float inv_scale, int32_t zp, uint8_t* out) {
+            const __m256 s = _mm256_set1_ps(inv_scale);
+            const __m256 z = _mm256_set1_ps(static_cast<float>(zp));
+            const __m256i lo = _mm256_setzero_si256();
+            size_t j = 0;
+            for (; j + 8 <= n; j += 8)
+                store_u7x8(_mm256_cvtps_epi32(_mm256_fmadd_ps(_mm256_loadu_ps(x + j), s, z)), lo, out + j);
+            return j;
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline size_t requantize_avx2(const int32_t* acc, size_t n, const float* mult, const float* off,
+                                      int32_t lo, uint8_t* out) {
+            const __m256i lov = _mm256_set1_epi32(lo);
+            size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                const __m256 y = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + j))),
+                                                 _mm256_loadu_ps(mult + j), _mm256_loadu_ps(off + j));
+                store_u7x8(_mm256_cvtps_epi32(y), lov, out + j);
+            }
+            return j;
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline size_t dequantize_avx2(const int32_t* acc, size_t n, const float* mult, const float* off,
+                                      bool relu, float* out) {
+            const __m256 zero = _mm256_setzero_ps();
+            size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                __m256 y = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + j))),
+                                           _mm256_loadu_ps(mult + j), _mm256_loadu_ps(off + j));
+                if (relu) y = _mm256_max_ps(y, zero);
+                _mm256_storeu_ps(out + j, y);
+            }
+            return j;
+        }
+#endif
+
+        inline bool int8_use_avx2() {
+            return int8_isa() != Int8Isa::Scalar;
+        }
+
+    }
+
+    // q = clamp(round(x * inv_scale) + zp, 0, 127)
+    inline void quantize_u7(const float* x, size_t n, float inv_scale, int32_t zp, uint8_t* out) {
+        size_t j = 0;
+#ifdef UTEC_GEMM_X86
+        if (detail::int8_use_avx2()) j = detail::quantize_avx2(x, n, inv_scale, zp, out);
+#endif
+        for (; j < n; ++j)
+            out[j] = detail::saturate_u7(static_cast<int32_t>(std::nearbyint(std::fma(x[j], inv_scale, float(zp)))), 0);
+    }
+
+    // Epílogo fusionado: q = clamp(round(acc * mult + off), lo, 127). mult y off ya incluyen
+    // escalas, bias y puntos cero; con lo = punto cero de salida se aplica además la ReLU.
+    inline void requantize_u7(const int32_t* acc, size_t n, const float* mult, const float* off,
+                              int32_t lo, uint8_t* out) {
+        size_t j = 0;
+#ifdef UTEC_GEMM_X86
+        if (detail::int8_use_avx2()) j = detail::requantize_avx2(acc, n, mult, off, lo, out);
+#endif
+        for (; j < n; ++j)
+            out[j] = detail::saturate_u7(static_cast<int32_t>(std::nearbyint(std::fma(float(acc[j]), mult[j], off[j]))), lo);
+    }
+
+    // y = acc * mult + off en float, con ReLU opcional
+    inline void dequantize_i32(const int32_t* acc, size_t n, const float* mult, const float* off,
+                               bool relu, float* out) {
+        size_t j = 0;
+#ifdef UTEC_GEMM_X86
+        if (detail::int8_use_avx2()) j = detail::dequantize_avx2(acc, n, mult, off, relu, out);
+#endif
+        for (; j < n; ++j) {
+            const float y = std::fma(float(acc[j]), mult[j], off[j]);
+            out[j] = relu && y < 0.0f ? 0.0f : y;
+        }
+    }
+
+}
+
+#endif // PROG3_TENSOR_FINAL_PROJECT_V2025_01_GEMM_INT8_H
@@ -0,0 +1,270 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_HALF_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_HALF_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define UTEC_HALF_X86 1
+#include <immintrin.h>
+#endif
+
+// Tipos de 16 bits solo para almacenamiento: bf16 (8 bits de exponente, mismo rango
+// que float) y fp16 IEEE (5 bits de exponente, más precisión y menos rango).
+// Toda operación se hace en float: el valor se convierte al leerlo y se redondea
+// (al par más cercano) al guardarlo, así que Tensor<bf16, R> ocupa la mitad de memoria.
+namespace utec::algebra {
+
+    namespace detail {
+
+        struct bf16_format {
+            static constexpr float to_float(uint16_t h) noexcept {
+                return std::bit_cast<float>(static_cast<uint32_t>(h) << 16);
+            }
+
+            static constexpr uint16_t from_float(float f) noexcept {
+                const uint32_t x = std::bit_cast<uint32_t>(f);
+                if ((x & 0x7fffffffu) > 0x7f800000u) return static_cast<uint16_t>((x >> 16) | 0x0040u);
+                return static_cast<uint16_t>((x + 0x7fffu + ((x >> 16) & 1u)) >> 16);
+            }
+        };
+
+        struct fp16_format {
+            static constexpr float to_float(uint16_t h) noexcept {
+                const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+                const uint32_t exp = (h >> 10) & 0x1fu;
+                const uint32_t mant = h & 0x3ffu;
+                if (exp == 0) {
+                    // Subnormal: mant * 2^-24 es exacto en float
+                    const float value = static_cast<float>(mant) * 5.9604644775390625e-8f;
+                    return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(value));
+                }
+                if (exp == 31) return std::bit_cast<float>(sign | 0x7f800000u | (mant << 13));
+                return std::bit_cast<float>(sign | ((exp + 112) << 23) | (mant << 13));
+            }
+
+            static constexpr uint16_t from_float(float f) noexcept {
+                uint32_t x = std::bit_cast<uint32_t>(f);
+                const uint32_t sign = (x >> 16) & 0x8000u;
+                x &= 0x7fffffffu;
+                uint32_t h;
+                if (x >= 0x7f800000u) {
+                    h = x > 0x7f800000u ? 0x7e00u : 0x7c00u;
+                } else if (x >= 0x477ff000u) {
+                    h = 0x7c00u;    // >= 65520 redondea a infinito
+                } else if (x < 0x38800000u) {
+                    // Subnormal o cero: sumar 0.5f deja el resultado redondeado en los bits bajos
+                    const float shifted = std::bit_cast<float>(x) + 0.5f;
+                    h = std::bit_cast<uint32_t>(shifted) - 0x3f000000u;
+                } else {
+                    // Rebase del exponente (127 -> 15) y redondeo al par
+                    h = (x + 0xc8000fffu + ((x >> 13) & 1u)) >> 13;
+                }
+                return static_cast<uint16_t>(sign | h);
+            }
+        };
+
+    }
+
+    // Trivial como uint16_t: T{} es cero y los buffers se llenan con memset/memcpy
+    template<typename Format>
+    class basic_half {
+        uint16_t bits_;
+
+    public:
+        constexpr basic_half() noexcept = default;
+        constexpr basic_half(float value) noexcept : bits_(Format::from_float(value)) {}
+
+        static constexpr basic_half from_bits(uint16_t bits) noexcept {
+            basic_half h{};
+            h.bits_ = bits;
+            return h;
+        }
+
+        constexpr uint16_t bits() const noexcept { return bits_; }
+        constexpr operator float() const noexcept { return Format::to_float(bits_); }
+
+        // La aritmética usa los operadores de float; estos permiten acumular sobre un half
+        constexpr basic_half& operator+=(float v) noexcept { return *this = float(*this) + v; }
+        constexpr basic_half& operator-=(float v) noexcept { return *this = float(*this) - v; }
+        constexpr basic_half& operator*=(float v) noexcept { return *this = float(*this) * v; }
+        constexpr basic_half& operator/=(float v) noexcept { return *this = float(*this) / v; }
+    };
+
+    using bf16 = basic_half<detail::bf16_format>;
+    using fp16 = basic_half<detail::fp16_format>;
+
+    template<typename T>
+    inline constexpr bool is_half_v = std::is_same_v<T, bf16> || std::is_same_v<T, fp16>;
+
+    // Tipo en el que se acumula y se guarda el estado: float para los tipos de 16 bits
+    template<typename T>
+    using accumulator_t = std::conditional_t<is_half_v<T>, float, T>;
+
+    template<typename Format>
+    std::ostream& operator<<(std::ostream& os, basic_half<Format> h) {
+        return os << static_cast<float>(h);
+    }
+
+    namespace detail {
+
+        inline bool half_cpu_supports_avx2_f16c() {
+#ifdef UTEC_HALF_X86
+            static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+            return ok;
+#else
+            return false;
+#endif
+        }
+
+        inline bool half_cpu_supports_avx512bf16() {
+#ifdef UTEC_HALF_X86
+            static const bool ok = __builtin_cpu_supports("avx512bf16");
+            return ok;
+#else
+            return false;
+#endif
+        }
+
+#ifdef UTEC_HALF_X86
+        __attribute__((target("avx,f16c")))
+        inline void fp16_to_float_f16c(const uint16_t* src, float* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+            for (; i < n; ++i) dst[i] = fp16_format::to_float(src[i]);
+        }
+
+        __attribute__((target("avx,f16c")))
+        inline void float_to_fp16_f16c(const float* src, uint16_t* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                                 _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+            for (; i < n; ++i) dst[i] = fp16_format::from_float(src[i]);
+        }
+
+        // bf16 -> float es un desplazamiento de 16 bits
+        __attribute__((target("avx2")))
+        inline void bf16_to_float_avx2(const uint16_t* src, float* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_slli_epi32(wide, 16));
+            }
+            for (; i < n; ++i) dst[i] = bf16_format::to_float(src[i]);
+        }
+
+        // Mismo redondeo que bf16_format::from_float, 8 valores a la vez
+        __attribute__((target("avx2")))
+        inline void float_to_bf16_avx2(const float* src, uint16_t* dst, size_t n) {
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i bias = _mm256_set1_epi32(0x7fff);
+            const __m256i abs_mask = _mm256_set1_epi32(0x7fffffff);
+            const __m256i inf = _mm256_set1_epi32(0x7f800000);
+            const __m256i quiet = _mm256_set1_epi32(0x00400000);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                __m256i half[2];
+                for (int h = 0; h < 2; ++h) {
+                    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8 * h));
+                    const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(x, 16), one);
+                    const __m256i rounded = _mm256_add_epi32(x, _mm256_add_epi32(bias, lsb));
+                    const __m256i nan = _mm256_cmpgt_epi32(_mm256_and_si256(x, abs_mask), inf);
+                    const __m256i value = _mm256_blendv_epi8(rounded, _mm256_or_si256(x, quiet), nan);
+                    half[h] = _mm256_srli_epi32(value, 16);
+                }
+                // packus intercala por carriles de 128 bits: permute recupera el orden
+                const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(half[0], half[1]), 0xd8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+            }
+            for (; i < n; ++i) dst[i] = bf16_format::from_float(src[i]);
+        }
+
+        // Conversión nativa de AVX-512 BF16 (vcvtne2ps2bf16), 32 valores por instrucción
+        __attribute__((target("avx512f,avx512bf16")))
+        inline void float_to_bf16_avx512(const float* src, uint16_t* dst, size_t n) {
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                const __m512bh packed = _mm512_cvtne2ps_pbh(_mm512_loadu_ps(src + i + 16), _mm512_loadu_ps(src + i));
+                _mm512_storeu_si512(dst + i, reinterpret_cast<const __m512i&>(packed));
+            }
+            for (; i < n; ++i) dst[i] = bf16_format::from_float(src[i]);
+        }
+#endif
+
+        inline const uint16_t* half_bits(const void* p) { return static_cast<const uint16_t*>(p); }
+        inline uint16_t* half_bits(void* p) { return static_cast<uint16_t*>(p); }
+
+    }
+
+    // Conversión por bloques entre float y los tipos de 16 bits (F16C / AVX2 / AVX-512 BF16
+    // si el CPU los tiene). La versión genérica cubre cualquier otro par de tipos.
+    template<typename From, typename To>
+    void convert(const From* src, To* dst, size_t n) {
+        for (size_t i = 0; i < n; ++i) dst[i] = static_cast<To>(src[i]);
+    }
+
+    inline void convert(const fp16* src, float* dst, size_t n) {
+#ifdef UTEC_HALF_X86
+        if (detail::half_cpu_supports_avx2_f16c()) return detail::fp16_to_float_f16c(detail::half_bits(src), dst, n);
+#endif
+        for (size_t i = 0; i < n; ++i) dst[i] = src[i];
+    }
+
+    inline void convert(const float* src, fp16* dst, size_t n) {
+#ifdef UTEC_HALF_X86
+        if (detail::half_cpu_supports_avx2_f16c()) return detail::float_to_fp16_f16c(src, detail::half_bits(dst), n);
+#endif
+        for (size_t i = 0; i < n; ++i) dst[i] = src[i];
+    }
+
+    inline void convert(const bf16* src, float* dst, size_t n) {
+#ifdef UTEC_HALF_X86
+        if (detail::half_cpu_supports_avx2_f16c()) return detail::bf16_to_float_avx2(detail::half_bits(src), dst, n);
+#endif
+        for (size_t i = 0; i < n; ++i) dst[i] = src[i];
+    }
+
+    inline void convert(const float* src, bf16* dst, size_t n) {
+#ifdef UTEC_HALF_X86
+        if (detail::half_cpu_supports_avx512bf16()) return detail::float_to_bf16_avx512(src, detail::half_bits(dst), n);
+        if (detail::half_cpu_supports_avx2_f16c()) return detail::float_to_bf16_avx2(src, detail::half_bits(dst), n);
+#endif
+        for (size_t i = 0; i < n; ++i) dst[i] = src[i];
+    }
+
+}
+
+namespace std {
+
+    template<typename Format>
+    class numeric_limits<utec::algebra::basic_half<Format>> {
+        using half = utec::algebra::basic_half<Format>;
+        static constexpr bool bf = std::is_same_v<Format, utec::algebra::detail::bf16_format>;
+
+    public:
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = false;
+        static constexpr bool has_infinity = true;
+        static constexpr bool has_quiet_NaN = true;
+        static constexpr int radix = 2;
+        static constexpr int digits = bf ? 8 : 11;
+
+        static constexpr half min() noexcept { return half::from_bits(bf ? 0x0080 : 0x0400); }
+        static constexpr half max() noexcept { return half::from_bits(bf ? 0x7f7f : 0x7bff); }
+        static constexpr half lowest() noexcept { return half::from_bits(bf ? 0xff7f : 0xfbff); }
+        static constexpr half epsilon() noexcept { return half::from_bits(bf ? 0x3c00 : 0x1400); }
+        static constexpr half infinity() noexcept { return half::from_bits(bf ? 0x7f80 : 0x7c00); }
+        static constexpr half quiet_NaN() noexcept { return half::from_bits(bf ? 0x7fc0 : 0x7e00); }
+    };
+
+}
+
+#endif //PROG3_TENSOR_FINAL_PROJECT_V2025_01_HALF_H
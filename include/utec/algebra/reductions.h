@@ -0,0 +1,449 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_REDUCTIONS_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_REDUCTIONS_H
+
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "tensor.h"
+#include "tensor_view.h"
+#include "static_tensor.h"
+#include "gemm.h"
+
+// Reducciones a lo largo de un eje: reduce_sum, reduce_max, argmax y mean.
+// El resultado conserva el rango, con tamaño 1 en el eje reducido (p. ej. (N, M) -> (1, M)),
+// así se combina directamente con el broadcasting de Tensor.
+// Los datos se ven como (outer, n, inner): se reduce n, y los bucles internos recorren
+// memoria contigua con acumuladores locales de tamaño fijo que el compilador vectoriza.
+namespace utec::algebra {
+
+    namespace detail {
+
+        // Caso base de la suma por pares: el error crece con O(log n) y no con O(n)
+        inline constexpr size_t reduce_block = 128;
+        // Acumuladores independientes al reducir memoria contigua
+        inline constexpr size_t reduce_lanes = 8;
+        // Columnas procesadas a la vez al reducir un eje que no es el último
+        inline constexpr size_t reduce_cols = 16;
+
+        // Las sumas acumulan en accumulator_t<T> (float para bf16 / fp16)
+        template <typename T>
+        accumulator_t<T> pairwise_sum(const T* x, size_t n) {
+            using A = accumulator_t<T>;
+            if (n > reduce_block) {
+                const size_t half = n / 2 / reduce_lanes * reduce_lanes;
+                return pairwise_sum(x, half) + pairwise_sum(x + half, n - half);
+            }
+            A acc[reduce_lanes] = {};
+            size_t i = 0;
+            for (; i + reduce_lanes <= n; i += reduce_lanes)
+                for (size_t j = 0; j < reduce_lanes; ++j) acc[j] += x[i + j];
+            A tail = A(0);
+            for (; i < n; ++i) tail += x[i];
+            for (size_t width = reduce_lanes / 2; width > 0; width /= 2)
+                for (size_t j = 0; j < width; ++j) acc[j] += acc[j + width];
+            return acc[0] + tail;
+        }
+
+        // out[0..W) = suma por pares de n filas de W columnas separadas por ld
+        template <size_t W, typename T, typename U>
+        void pairwise_rows(const T* x, size_t n, size_t ld, U* out) {
+            using A = accumulator_t<T>;
+            if (n > reduce_block) {
+                const size_t half = n / 2;
+                A left[W], right[W];
+                pairwise_rows<W>(x, half, ld, left);
+                pairwise_rows<W>(x + half * ld, n - half, ld, right);
+                for (size_t j = 0; j < W; ++j) out[j] = left[j] + right[j];
+                return;
+            }
+            A acc[W] = {};
+            for (size_t a = 0; a < n; ++a) {
+                const T* row = x + a * ld;
+                for (size_t j = 0; j < W; ++j) acc[j] += row[j];
+            }
+            std::copy_n(acc, W, out);
+        }
+
+        // Como en un bucle con '>' estricto: un NaN solo gana si es el primer elemento
+        template <typename T>
+        T max_contiguous(const T* x, size_t n) {
+            T acc[reduce_lanes];
+            std::fill_n(acc, reduce_lanes, x[0]);
+            size_t i = 0;
+            for (; i + reduce_lanes <= n; i += reduce_lanes)
+                for (size_t j = 0; j < reduce_lanes; ++j) acc[j] = acc[j] < x[i + j] ? x[i + j] : acc[j];
+            T best = acc[0];
+            for (size_t j = 1; j < reduce_lanes; ++j) best = best < acc[j] ? acc[j] : best;
+            for (; i < n; ++i) best = best < x[i] ? x[i] : best;
+            return best;
+        }
+
+        template <size_t W, typename T>
+        void max_rows(const T* x, size_t n, size_t ld, T* out) {
+            T acc[W];
+            std::copy_n(x, W, acc);
+            for (size_t a = 1; a < n; ++a) {
+                const T* row = x + a * ld;
+                for (size_t j = 0; j < W; ++j) acc[j] = acc[j] < row[j] ? row[j] : acc[j];
+            }
+            std::copy_n(acc, W, out);
+        }
+
+#ifdef UTEC_GEMM_X86
+        // Versiones AVX para float de los mismos kernels, con los mismos resultados salvo redondeo
+
+        __attribute__((target("avx")))
+        inline float horizontal_sum_avx(__m256 v) {
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, v);
+            return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+        }
+
+        __attribute__((target("avx")))
+        inline float pairwise_sum_avx(const float* x, size_t n) {
+            if (n > reduce_block) {
+                const size_t half = n / 2 / reduce_lanes * reduce_lanes;
+                return pairwise_sum_avx(x, half) + pairwise_sum_avx(x + half, n - half);
+            }
+            __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+            __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                a0 = _mm256_add_ps(a0, _mm256_loadu_ps(x + i));
+                a1 = _mm256_add_ps(a1, _mm256_loadu_ps(x + i + 8));
+                a2 = _mm256_add_ps(a2, _mm256_loadu_ps(x + i + 16));
+                a3 = _mm256_add_ps(a3, _mm256_loadu_ps(x + i + 24));
+            }
+            for (; i + 8 <= n; i += 8) a0 = _mm256_add_ps(a0, _mm256_loadu_ps(x + i));
+            float tail = 0.0f;
+            for (; i < n; ++i) tail += x[i];
+            return horizontal_sum_avx(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3))) + tail;
+        }
+
+        // Bloque de 16 columnas en dos registros
+        __attribute__((target("avx")))
+        inline void pairwise_rows_avx(const float* x, size_t n, size_t ld, __m256& lo, __m256& hi) {
+            if (n > reduce_block) {
+                const size_t half = n / 2;
+                __m256 lo2, hi2;
+                pairwise_rows_avx(x, half, ld, lo, hi);
+                pairwise_rows_avx(x + half * ld, n - half, ld, lo2, hi2);
+                lo = _mm256_add_ps(lo, lo2);
+                hi = _mm256_add_ps(hi, hi2);
+                return;
+            }
+            lo = _mm256_setzero_ps();
+            hi = _mm256_setzero_ps();
+            for (size_t a = 0; a < n; ++a) {
+                lo = _mm256_add_ps(lo, _mm256_loadu_ps(x + a * ld));
+                hi = _mm256_add_ps(hi, _mm256_loadu_ps(x + a * ld + 8));
+            }
+        }
+
+        __attribute__((target("avx")))
+        inline void pairwise_rows16_avx(const float* x, size_t n, size_t ld, float* out) {
+            __m256 lo, hi;
+            pairwise_rows_avx(x, n, ld, lo, hi);
+            _mm256_storeu_ps(out, lo);
+            _mm256_storeu_ps(out + 8, hi);
+        }
+
+        // max_ps(x, acc) devuelve acc si x es NaN: mismo criterio que max_contiguous
+        __attribute__((target("avx")))
+        inline float max_contiguous_avx(const float* x, size_t n) {
+            __m256 a0 = _mm256_set1_ps(x[0]), a1 = a0, a2 = a0, a3 = a0;
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                a0 = _mm256_max_ps(_mm256_loadu_ps(x + i), a0);
+                a1 = _mm256_max_ps(_mm256_loadu_ps(x + i + 8), a1);
+                a2 = _mm256_max_ps(_mm256_loadu_ps(x + i + 16), a2);
+                a3 = _mm256_max_ps(_mm256_loadu_ps(x + i + 24), a3);
+            }
+            for (; i + 8 <= n; i += 8) a0 = _mm256_max_ps(_mm256_loadu_ps(x + i), a0);
+            a0 = _mm256_max_ps(a1, a0);
+            a2 = _mm256_max_ps(a3, a2);
+            a0 = _mm256_max_ps(a2, a0);
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, a0);
+            float best = lanes[0];
+            for (size_t j = 1; j < 8; ++j) best = best < lanes[j] ? lanes[j] : best;
+            for (; i < n; ++i) best = best < x[i] ? x[i] : best;
+            return best;
+        }
+
+        __attribute__((target("avx")))
+        inline void max_rows16_avx(const float* x, size_t n, size_t ld, float* out) {
+            __m256 lo = _mm256_loadu_ps(x), hi = _mm256_loadu_ps(x + 8);
+            for (size_t a = 1; a < n; ++a) {
+                lo = _mm256_max_ps(_mm256_loadu_ps(x + a * ld), lo);
+                hi = _mm256_max_ps(_mm256_loadu_ps(x + a * ld + 8), hi);
+            }
+            _mm256_storeu_ps(out, lo);
+            _mm256_storeu_ps(out + 8, hi);
+        }
+#endif
+
+        // Igual que la transpuesta, los kernels AVX siguen al ISA activo de GEMM
+        template <typename T>
+        bool use_reduce_avx() {
+#ifdef UTEC_GEMM_X86
+            return std::is_same_v<T, float> && gemm_isa() != GemmIsa::Scalar;
+#else
+            return false;
+#endif
+        }
+
+        template <typename T>
+        T sum_contiguous(const T* x, size_t n, bool avx) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                if (avx) return pairwise_sum_avx(x, n);
+            }
+#endif
+            (void)avx;
+            return pairwise_sum(x, n);
+        }
+
+        template <typename T>
+        void sum_rows16(const T* x, size_t n, size_t ld, T* out, bool avx) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                if (avx) return pairwise_rows16_avx(x, n, ld, out);
+            }
+#endif
+            (void)avx;
+            pairwise_rows<reduce_cols>(x, n, ld, out);
+        }
+
+        template <typename T>
+        T max_contiguous(const T* x, size_t n, bool avx) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                if (avx) return max_contiguous_avx(x, n);
+            }
+#endif
+            (void)avx;
+            return max_contiguous(x, n);
+        }
+
+        template <typename T>
+        void max_rows16(const T* x, size_t n, size_t ld, T* out, bool avx) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                if (avx) return max_rows16_avx(x, n, ld, out);
+            }
+#endif
+            (void)avx;
+            max_rows<reduce_cols>(x, n, ld, out);
+        }
+
+        template <typename T>
+        void sum_axis(const T* x, size_t outer, size_t n, size_t inner, T* out) {
+            const bool avx = use_reduce_avx<T>();
+            for (size_t o = 0; o < outer; ++o) {
+                const T* xo = x + o * n * inner;
+                T* oo = out + o * inner;
+                if (inner == 1) {
+                    *oo = sum_contiguous(xo, n, avx);
+                    continue;
+                }
+                size_t i = 0;
+                for (; i + reduce_cols <= inner; i += reduce_cols) sum_rows16(xo + i, n, inner, oo + i, avx);
+                for (; i < inner; ++i) pairwise_rows<1>(xo + i, n, inner, oo + i);
+            }
+        }
+
+        template <typename T>
+        void max_axis(const T* x, size_t outer, size_t n, size_t inner, T* out) {
+            const bool avx = use_reduce_avx<T>();
+            for (size_t o = 0; o < outer; ++o) {
+                const T* xo = x + o * n * inner;
+                T* oo = out + o * inner;
+                if (inner == 1) {
+                    *oo = max_contiguous(xo, n, avx);
+                    continue;
+                }
+                size_t i = 0;
+                for (; i + reduce_cols <= inner; i += reduce_cols) max_rows16(xo + i, n, inner, oo + i, avx);
+                for (; i < inner; ++i) max_rows<1>(xo + i, n, inner, oo + i);
+            }
+        }
+
+        // Por debajo de este largo argmax recorre la fila una vez; por encima busca
+        // primero el máximo con el kernel vectorizado y luego su primera posición
+        inline constexpr size_t argmax_scan_max = 64;
+
+        // Primer índice del máximo (0 si el primer elemento es NaN)
+        template <typename T>
+        void argmax_axis(const T* x, size_t outer, size_t n, size_t inner, size_t* out) {
+            const bool avx = use_reduce_avx<T>();
+            for (size_t o = 0; o < outer; ++o) {
+                const T* xo = x + o * n * inner;
+                size_t* oo = out + o * inner;
+                if (inner == 1 && n > argmax_scan_max) {
+                    const T best = max_contiguous(xo, n, avx);
+                    const size_t idx = static_cast<size_t>(std::find(xo, xo + n, best) - xo);
+                    *oo = idx < n ? idx : 0;
+                    continue;
+                }
+                for (size_t i = 0; i < inner; ++i) {
+                    T best = xo[i];
+                    size_t best_a = 0;
+                    for (size_t a = 1; a < n; ++a) {
+                        if (best < xo[a * inner + i]) {
+                            best = xo[a * inner + i];
+                            best_a = a;
+                        }
+                    }
+                    oo[i] = best_a;
+                }
+            }
+        }
+
+        // Operandos de las reducciones: Tensor (con cualquier almacenamiento), TensorView y StaticTensor
+        template <typename X>
+        struct reduce_operand : std::false_type {};
+
+        template <typename T, size_t Rank, typename Storage>
+        struct reduce_operand<Tensor<T, Rank, Storage>> : std::true_type {
+            using value_type = T;
+            static constexpr size_t rank = Rank;
+        };
+
+        template <typename T, size_t Rank>
+        struct reduce_operand<TensorView<T, Rank>> : std::true_type {
+            using value_type = std::remove_const_t<T>;
+            static constexpr size_t rank = Rank;
+        };
+
+        template <typename T, size_t... Dims>
+        struct reduce_operand<StaticTensor<T, Dims...>> : std::true_type {
+            using value_type = T;
+            static constexpr size_t rank = sizeof...(Dims);
+        };
+
+    }
+
+    template <typename X>
+    concept ReduceOperand = detail::reduce_operand<std::remove_cvref_t<X>>::value;
+
+    template <typename X>
+    using reduce_value_t = typename detail::reduce_operand<std::remove_cvref_t<X>>::value_type;
+
+    template <typename X>
+    inline constexpr size_t reduce_rank_v = detail::reduce_operand<std::remove_cvref_t<X>>::rank;
+
+    namespace detail {
+
+        // Recorre x como (outer, n, inner) sobre memoria contigua; si la vista no lo es, copia antes
+        template <typename X, typename Out, typename Kernel>
+        void reduce_axis(const X& x, size_t axis, Out* out, bool needs_elements, Kernel kernel) {
+            using T = reduce_value_t<X>;
+            constexpr size_t Rank = reduce_rank_v<X>;
+            TensorView<const T, Rank> v(x);
+            if (axis >= Rank) throw std::out_of_range("Axis out of range");
+            const auto& shape = v.shape();
+            size_t outer = 1, inner = 1;
+            for (size_t d = 0; d < axis; ++d) outer *= shape[d];
+            for (size_t d = axis + 1; d < Rank; ++d) inner *= shape[d];
+            if (outer == 0 || inner == 0) return;
+            if (needs_elements && shape[axis] == 0) throw std::invalid_argument("Cannot reduce an empty axis");
+            if (v.is_contiguous()) {
+                kernel(v.data(), outer, shape[axis], inner, out);
+            } else {
+                Tensor<T, Rank> copy = materialize(v);
+                kernel(copy.raw_data(), outer, shape[axis], inner, out);
+            }
+        }
+
+        template <size_t Rank>
+        std::array<size_t, Rank> reduced_shape(std::array<size_t, Rank> shape, size_t axis) {
+            if (axis >= Rank) throw std::out_of_range("Axis out of range");
+            shape[axis] = 1;
+            return shape;
+        }
+
+        template <typename Out, size_t Rank>
+        void check_reduced_output(const TensorView<Out, Rank>& out, const std::array<size_t, Rank>& shape) {
+            if (out.shape() != shape || !out.is_contiguous()) {
+                throw std::invalid_argument("Output shape does not match the reduced shape");
+            }
+        }
+
+    }
+
+    // Suma por pares a lo largo de `axis`
+    template <ReduceOperand X>
+    void reduce_sum_into(const X& x, size_t axis, Tensor<reduce_value_t<X>, reduce_rank_v<X>>& out) {
+        using T = reduce_value_t<X>;
+        out.reshape(detail::reduced_shape(TensorView<const T, reduce_rank_v<X>>(x).shape(), axis));
+        detail::reduce_axis(x, axis, out.raw_data(), false, detail::sum_axis<T>);
+    }
+
+    // Variante para destinos de forma fija (p. ej. un StaticTensor o una vista)
+    template <ReduceOperand X>
+    void reduce_sum_into(const X& x, size_t axis, TensorView<reduce_value_t<X>, reduce_rank_v<X>> out) {
+        using T = reduce_value_t<X>;
+        detail::check_reduced_output(out, detail::reduced_shape(TensorView<const T, reduce_rank_v<X>>(x).shape(), axis));
+        detail::reduce_axis(x, axis, out.data(), false, detail::sum_axis<T>);
+    }
+
+    template <ReduceOperand X>
+    Tensor<reduce_value_t<X>, reduce_rank_v<X>> reduce_sum(const X& x, size_t axis) {
+        Tensor<reduce_value_t<X>, reduce_rank_v<X>> out;
+        reduce_sum_into(x, axis, out);
+        return out;
+    }
+
+    template <ReduceOperand X>
+    void reduce_max_into(const X& x, size_t axis, Tensor<reduce_value_t<X>, reduce_rank_v<X>>& out) {
+        using T = reduce_value_t<X>;
+        out.reshape(detail::reduced_shape(TensorView<const T, reduce_rank_v<X>>(x).shape(), axis));
+        detail::reduce_axis(x, axis, out.raw_data(), true, detail::max_axis<T>);
+    }
+
+    template <ReduceOperand X>
+    Tensor<reduce_value_t<X>, reduce_rank_v<X>> reduce_max(const X& x, size_t axis) {
+        Tensor<reduce_value_t<X>, reduce_rank_v<X>> out;
+        reduce_max_into(x, axis, out);
+        return out;
+    }
+
+    // Índice del primer máximo a lo largo de `axis`
+    template <ReduceOperand X>
+    void argmax_into(const X& x, size_t axis, Tensor<size_t, reduce_rank_v<X>>& out) {
+        using T = reduce_value_t<X>;
+        out.reshape(detail::reduced_shape(TensorView<const T, reduce_rank_v<X>>(x).shape(), axis));
+        detail::reduce_axis(x, axis, out.raw_data(), true, detail::argmax_axis<T>);
+    }
+
+    template <ReduceOperand X>
+    Tensor<size_t, reduce_rank_v<X>> argmax(const X& x, size_t axis) {
+        Tensor<size_t, reduce_rank_v<X>> out;
+        argmax_into(x, axis, out);
+        return out;
+    }
+
+    template <ReduceOperand X>
+    void mean_into(const X& x, size_t axis, Tensor<reduce_value_t<X>, reduce_rank_v<X>>& out) {
+        using T = reduce_value_t<X>;
+        const auto shape = TensorView<const T, reduce_rank_v<X>>(x).shape();
+        if (axis >= shape.size()) throw std::out_of_range("Axis out of range");
+        const size_t n = shape[axis];
+        if (n == 0) throw std::invalid_argument("Cannot reduce an empty axis");
+        reduce_sum_into(x, axis, out);
+        const T inv = T(1) / static_cast<T>(n);
+        for (auto& value : out) value *= inv;
+    }
+
+    template <ReduceOperand X>
+    Tensor<reduce_value_t<X>, reduce_rank_v<X>> mean(const X& x, size_t axis) {
+        Tensor<reduce_value_t<X>, reduce_rank_v<X>> out;
+        mean_into(x, axis, out);
+        return out;
+    }
+
+}
+
+#endif //PROG3_TENSOR_FINAL_PROJECT_V2025_01_REDUCTIONS_H
@@ -0,0 +1,404 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_SPARSE_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_SPARSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "tensor.h"
+#include "tensor_view.h"
+#include "gemm.h"
+
+// Matrices dispersas en formato CSR (filas comprimidas) para entradas con muchos ceros,
+// como los píxeles de fondo de MNIST. Los productos con una matriz densa solo recorren
+// los valores no nulos: O(nnz × n) en lugar de O(m × k × n).
+namespace utec::algebra {
+
+    // Por debajo de esta fracción de no nulos el producto CSR gana al GEMM empaquetado
+    // (medido con la primera capa 64 -> 128 de MNIST 8x8 y lotes de 5 a 256 filas)
+    inline constexpr double csr_density_threshold = 0.5;
+
+    namespace detail {
+
+        // Copia los no nulos de una fila (paso cs) a values / cols, con columnas desde `first`;
+        // devuelve cuántos hay. Escribe sin ramas: ambos destinos necesitan espacio para n elementos
+        template <typename T>
+        size_t compress_row_generic(const T* row, size_t n, size_t cs, T* values, uint32_t* cols,
+                                    size_t first = 0) {
+            size_t nz = 0;
+            for (size_t j = 0; j < n; ++j) {
+                const T v = row[j * cs];
+                cols[nz] = static_cast<uint32_t>(first + j);
+                values[nz] = v;
+                nz += v != T(0);
+            }
+            return nz;
+        }
+
+        template <typename T>
+        size_t count_nonzero_generic(const T* row, size_t n, size_t cs) {
+            size_t nz = 0;
+            for (size_t j = 0; j < n; ++j) nz += row[j * cs] != T(0);
+            return nz;
+        }
+
+#ifdef UTEC_GEMM_X86
+        // vcompressps guarda solo los carriles no nulos: 16 elementos por iteración
+        __attribute__((target("avx512f,popcnt")))
+        inline size_t compress_row_avx512(const float* row, size_t n, float* values, uint32_t* cols) {
+            const __m512 zero = _mm512_setzero_ps();
+            const __m512i step = _mm512_set1_epi32(16);
+            __m512i idx = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            size_t nz = 0, j = 0;
+            for (; j + 16 <= n; j += 16, idx = _mm512_add_epi32(idx, step)) {
+                const __m512 v = _mm512_loadu_ps(row + j);
+                const __mmask16 keep = _mm512_cmp_ps_mask(v, zero, _CMP_NEQ_UQ);
+                _mm512_mask_compressstoreu_ps(values + nz, keep, v);
+                _mm512_mask_compressstoreu_epi32(cols + nz, keep, idx);
+                nz += static_cast<size_t>(_mm_popcnt_u32(keep));
+            }
+            return nz + compress_row_generic(row + j, n - j, 1, values + nz, cols + nz, j);
+        }
+
+        __attribute__((target("avx2,popcnt")))
+        inline size_t count_nonzero_avx2(const float* row, size_t n) {
+            const __m256 zero = _mm256_setzero_ps();
+            size_t nz = 0, j = 0;
+            for (; j + 8 <= n; j += 8)
+                nz += static_cast<size_t>(_mm_popcnt_u32(static_cast<unsigned>(
+                    _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(row + j), zero, _CMP_NEQ_UQ)))));
+            return nz + count_nonzero_generic(row + j, n - j, 1);
+        }
+#endif
+
+        template <typename T>
+        size_t compress_row(const T* row, size_t n, size_t cs, T* values, uint32_t* cols) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                if (cs == 1 && gemm_isa() == GemmIsa::AVX512) return compress_row_avx512(row, n, values, cols);
+            }
+#endif
+            return compress_row_generic(row, n, cs, values, cols);
+        }
+
+        template <typename T>
+        size_t count_nonzero(const T* row, size_t n, size_t cs) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                if (cs == 1 && gemm_isa() != GemmIsa::Scalar) return count_nonzero_avx2(row, n);
+            }
+#endif
+            return count_nonzero_generic(row, n, cs);
+        }
+
+    }
+
+    template <typename T>
+    class CsrMatrix {
+        size_t rows_ = 0, cols_ = 0, nnz_ = 0;
+        std::vector<size_t> row_ptr_{0};
+        // Con capacidad para rows_ x cols_: assign escribe sin ramas y solo avanza en los no nulos
+        std::vector<uint32_t> col_idx_;
+        std::vector<T> values_;
+
+    public:
+        CsrMatrix() = default;
+
+        explicit CsrMatrix(TensorView<const T, 2> dense) { assign(dense); }
+
+        // Memoria para una matriz densa de rows x cols: assign posteriores no reservan
+        void reserve(size_t rows, size_t cols) {
+            row_ptr_.reserve(rows + 1);
+            if (values_.size() < rows * cols) {
+                values_.resize(rows * cols);
+                col_idx_.resize(rows * cols);
+            }
+        }
+
+        // Reconstruye a partir de una matriz densa reutilizando la memoria ya reservada
+        void assign(TensorView<const T, 2> dense) {
+            rows_ = dense.shape()[0];
+            cols_ = dense.shape()[1];
+            reserve(rows_, cols_);
+            row_ptr_.resize(rows_ + 1);
+            const size_t cs = dense.strides()[1];
+            size_t nz = 0;
+            for (size_t i = 0; i < rows_; ++i) {
+                row_ptr_[i] = nz;
+                const T* row = cols_ ? dense.data() + dense.offset({i, 0}) : nullptr;
+                nz += detail::compress_row(row, cols_, cs, values_.data() + nz, col_idx_.data() + nz);
+            }
+            row_ptr_[rows_] = nz;
+            nnz_ = nz;
+        }
+
+        size_t rows() const noexcept { return rows_; }
+        size_t cols() const noexcept { return cols_; }
+        size_t nnz() const noexcept { return nnz_; }
+        double density() const noexcept {
+            return rows_ * cols_ == 0 ? 0.0 : static_cast<double>(nnz_) / static_cast<double>(rows_ * cols_);
+        }
+
+        const size_t* row_ptr() const noexcept { return row_ptr_.data(); }
+        const uint32_t* col_idx() const noexcept { return col_idx_.data(); }
+        const T* values() const noexcept { return values_.data(); }
+
+        Tensor<T, 2> to_dense() const {
+            Tensor<T, 2> dense(rows_, cols_);
+            for (size_t i = 0; i < rows_; ++i)
+                for (size_t p = row_ptr_[i]; p < row_ptr_[i + 1]; ++p)
+                    dense(i, col_idx_[p]) = values_[p];
+            return dense;
+        }
+    };
+
+    // Fracción de elementos no nulos; O(m × k) sin reservar memoria
+    template <MatrixOperand A>
+    double density(const A& a) {
+        using T = operand_value_t<A>;
+        const TensorView<const T, 2> x(a);
+        const size_t m = x.shape()[0], k = x.shape()[1];
+        if (m * k == 0) return 0.0;
+        size_t nnz = 0;
+        for (size_t i = 0; i < m; ++i)
+            nnz += detail::count_nonzero(x.data() + x.offset({i, 0}), k, x.strides()[1]);
+        return static_cast<double>(nnz) / static_cast<double>(m * k);
+    }
+
+    namespace detail {
+
+        // C(m x n) = A(CSR) * B, con B de filas contiguas (paso ldb). Cada fila de C se
+        // acumula por bloques de columnas en registros: un no nulo cuesta una fila de B
+        template <typename T>
+        void spmm_generic(size_t m, size_t n, const size_t* rp, const uint32_t* ci, const T* v,
+                          const T* b, size_t ldb, T* c, size_t ldc) {
+            constexpr size_t block = 64;
+            for (size_t j0 = 0; j0 < n; j0 += block) {
+                const size_t w = std::min(block, n - j0);
+                for (size_t i = 0; i < m; ++i) {
+                    T acc[block] = {};
+                    for (size_t p = rp[i]; p < rp[i + 1]; ++p) {
+                        const T a = v[p];
+                        const T* brow = b + ci[p] * ldb + j0;
+                        for (size_t j = 0; j < w; ++j) acc[j] += a * brow[j];
+                    }
+                    std::copy(acc, acc + w, c + i * ldc + j0);
+                }
+            }
+        }
+
+        // C(k x n) = Aᵀ * B: la fila i de B se suma a la fila col(p) de C por cada no nulo de
+        // la fila i de A. C debe llegar en cero; sus filas sin no nulos no se tocan
+        template <typename T>
+        void spmm_tn_generic(size_t m, size_t n, const size_t* rp, const uint32_t* ci, const T* v,
+                             const T* b, size_t ldb, T* c, size_t ldc) {
+            for (size_t i = 0; i < m; ++i) {
+                const T* bi = b + i * ldb;
+                for (size_t p = rp[i]; p < rp[i + 1]; ++p) {
+                    const T a = v[p];
+                    T* crow = c + ci[p] * ldc;
+                    for (size_t j = 0; j < n; ++j) crow[j] += a * bi[j];
+                }
+            }
+        }
+
+#ifdef UTEC_GEMM_X86
+        __attribute__((target("avx2,fma")))
+        inline void spmm_avx2(size_t m, size_t n, const size_t* rp, const uint32_t* ci, const float* v,
+                              const float* b, size_t ldb, float* c, size_t ldc) {
+            constexpr size_t nv = 8;
+            size_t j0 = 0;
+            for (; j0 + nv * 8 <= n; j0 += nv * 8) {
+                for (size_t i = 0; i < m; ++i) {
+                    __m256 acc[nv];
+#pragma GCC unroll 8
+                    for (size_t q = 0; q < nv; ++q) acc[q] = _mm256_setzero_ps();
+                    for (size_t p = rp[i]; p < rp[i + 1]; ++p) {
+                        const __m256 a = _mm256_set1_ps(v[p]);
+                        const float* brow = b + ci[p] * ldb + j0;
+#pragma GCC unroll 8
+                        for (size_t q = 0; q < nv; ++q)
+                            acc[q] = _mm256_fmadd_ps(a, _mm256_loadu_ps(brow + q * 8), acc[q]);
+                    }
+#pragma GCC unroll 8
+                    for (size_t q = 0; q < nv; ++q) _mm256_storeu_ps(c + i * ldc + j0 + q * 8, acc[q]);
+                }
+            }
+            if (j0 < n) spmm_generic(m, n - j0, rp, ci, v, b + j0, ldb, c + j0, ldc);
+        }
+
+        // La fila de B vive en registros mientras se suma a cada fila destino
+        __attribute__((target("avx2,fma")))
+        inline void spmm_tn_avx2(size_t m, size_t n, const size_t* rp, const uint32_t* ci, const float* v,
+                                 const float* b, size_t ldb, float* c, size_t ldc) {
+            constexpr size_t nv = 8;
+            size_t j0 = 0;
+            for (; j0 + nv * 8 <= n; j0 += nv * 8) {
+                for (size_t i = 0; i < m; ++i) {
+                    __m256 bi[nv];
+#pragma GCC unroll 8
+                    for (size_t q = 0; q < nv; ++q) bi[q] = _mm256_loadu_ps(b + i * ldb + j0 + q * 8);
+                    for (size_t p = rp[i]; p < rp[i + 1]; ++p) {
+                        const __m256 a = _mm256_set1_ps(v[p]);
+                        float* crow = c + ci[p] * ldc + j0;
+#pragma GCC unroll 8
+                        for (size_t q = 0; q < nv; ++q)
+                            _mm256_storeu_ps(crow + q * 8, _mm256_fmadd_ps(a, bi[q], _mm256_loadu_ps(crow + q * 8)));
+                    }
+                }
+            }
+            if (j0 < n) spmm_tn_generic(m, n - j0, rp, ci, v, b + j0, ldb, c + j0, ldc);
+        }
+
+        // Tesela de una fila de C y NV registros zmm (16 columnas cada uno) en registros
+        template <size_t NV>
+        __attribute__((target("avx512f")))
+        inline void spmm_row_avx512(size_t begin, size_t end, const uint32_t* ci, const float* v,
+                                    const float* b, size_t ldb, float* c, __mmask16 tail) {
+            __m512 acc[NV];
+#pragma GCC unroll 8
+            for (size_t q = 0; q < NV; ++q) acc[q] = _mm512_setzero_ps();
+            for (size_t p = begin; p < end; ++p) {
+                const __m512 a = _mm512_set1_ps(v[p]);
+                const float* brow = b + ci[p] * ldb;
+#pragma GCC unroll 8
+                for (size_t q = 0; q + 1 < NV; ++q)
+                    acc[q] = _mm512_fmadd_ps(a, _mm512_loadu_ps(brow + q * 16), acc[q]);
+                acc[NV - 1] = _mm512_fmadd_ps(a, _mm512_maskz_loadu_ps(tail, brow + (NV - 1) * 16), acc[NV - 1]);
+            }
+#pragma GCC unroll 8
+            for (size_t q = 0; q + 1 < NV; ++q) _mm512_storeu_ps(c + q * 16, acc[q]);
+            _mm512_mask_storeu_ps(c + (NV - 1) * 16, tail, acc[NV - 1]);
+        }
+
+        // Bloques de hasta 128 columnas (8 registros zmm); solo el último vector usa máscara
+        __attribute__((target("avx512f")))
+        inline void spmm_avx512(size_t m, size_t n, const size_t* rp, const uint32_t* ci, const float* v,
+                                const float* b, size_t ldb, float* c, size_t ldc) {
+            using RowFn = void (*)(size_t, size_t, const uint32_t*, const float*, const float*, size_t, float*, __mmask16);
+            static constexpr RowFn rows_by_width[8] = {
+                &spmm_row_avx512<1>, &spmm_row_avx512<2>, &spmm_row_avx512<3>, &spmm_row_avx512<4>,
+                &spmm_row_avx512<5>, &spmm_row_avx512<6>, &spmm_row_avx512<7>, &spmm_row_avx512<8>};
+            for (size_t j0 = 0; j0 < n; j0 += 128) {
+                const size_t w = std::min<size_t>(128, n - j0);
+                const size_t nv = (w + 15) / 16;
+                const __mmask16 tail = w % 16 ? static_cast<__mmask16>((1u << (w % 16)) - 1) : __mmask16(0xffff);
+                const RowFn row = rows_by_width[nv - 1];
+                for (size_t i = 0; i < m; ++i) row(rp[i], rp[i + 1], ci, v, b + j0, ldb, c + i * ldc + j0, tail);
+            }
+        }
+
+        template <size_t NV>
+        __attribute__((target("avx512f")))
+        inline void spmm_tn_row_avx512(size_t begin, size_t end, const uint32_t* ci, const float* v,
+                                       const float* brow, float* c, size_t ldc, __mmask16 tail) {
+            __m512 bi[NV];
+#pragma GCC unroll 8
+            for (size_t q = 0; q + 1 < NV; ++q) bi[q] = _mm512_loadu_ps(brow + q * 16);
+            bi[NV - 1] = _mm512_maskz_loadu_ps(tail, brow + (NV - 1) * 16);
+            for (size_t p = begin; p < end; ++p) {
+                const __m512 a = _mm512_set1_ps(v[p]);
+                float* crow = c + ci[p] * ldc;
+#pragma GCC unroll 8
+                for (size_t q = 0; q + 1 < NV; ++q)
+                    _mm512_storeu_ps(crow + q * 16, _mm512_fmadd_ps(a, bi[q], _mm512_loadu_ps(crow + q * 16)));
+                float* last = crow + (NV - 1) * 16;
+                _mm512_mask_storeu_ps(last, tail, _mm512_fmadd_ps(a, bi[NV - 1], _mm512_maskz_loadu_ps(tail, last)));
+            }
+        }
+
+        __attribute__((target("avx512f")))
+        inline void spmm_tn_avx512(size_t m, size_t n, const size_t* rp, const uint32_t* ci, const float* v,
+                                   const float* b, size_t ldb, float* c, size_t ldc) {
+            using RowFn = void (*)(size_t, size_t, const uint32_t*, const float*, const float*, float*, size_t, __mmask16);
+            static constexpr RowFn rows_by_width[8] = {
+                &spmm_tn_row_avx512<1>, &spmm_tn_row_avx512<2>, &spmm_tn_row_avx512<3>, &spmm_tn_row_avx512<4>,
+                &spmm_tn_row_avx512<5>, &spmm_tn_row_avx512<6>, &spmm_tn_row_avx512<7>, &spmm_tn_row_avx512<8>};
+            for (size_t j0 = 0; j0 < n; j0 += 128) {
+                const size_t w = std::min<size_t>(128, n - j0);
+                const __mmask16 tail = w % 16 ? static_cast<__mmask16>((1u << (w % 16)) - 1) : __mmask16(0xffff);
+                const RowFn row = rows_by_width[(w + 15) / 16 - 1];
+                for (size_t i = 0; i < m; ++i) row(rp[i], rp[i + 1], ci, v, b + i * ldb + j0, c + j0, ldc, tail);
+            }
+        }
+#endif
+
+        template <typename T>
+        void spmm(size_t m, size_t n, const size_t* rp, const uint32_t* ci, const T* v,
+                  const T* b, size_t ldb, T* c, size_t ldc) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                switch (gemm_isa()) {
+                    case GemmIsa::AVX512: return spmm_avx512(m, n, rp, ci, v, b, ldb, c, ldc);
+                    case GemmIsa::AVX2:   return spmm_avx2(m, n, rp, ci, v, b, ldb, c, ldc);
+                    default: break;
+                }
+            }
+#endif
+            spmm_generic(m, n, rp, ci, v, b, ldb, c, ldc);
+        }
+
+        template <typename T>
+        void spmm_tn(size_t m, size_t n, const size_t* rp, const uint32_t* ci, const T* v,
+                     const T* b, size_t ldb, T* c, size_t ldc) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                switch (gemm_isa()) {
+                    case GemmIsa::AVX512: return spmm_tn_avx512(m, n, rp, ci, v, b, ldb, c, ldc);
+                    case GemmIsa::AVX2:   return spmm_tn_avx2(m, n, rp, ci, v, b, ldb, c, ldc);
+                    default: break;
+                }
+            }
+#endif
+            spmm_tn_generic(m, n, rp, ci, v, b, ldb, c, ldc);
+        }
+
+        // Filas de B con paso uniforme y columnas contiguas: si la vista no lo cumple, se copia
+        template <typename T>
+        TensorView<const T, 2> contiguous_rows(TensorView<const T, 2> b, Tensor<T, 2>& scratch) {
+            if (b.strides()[1] == 1 && b.row_indices() == nullptr) return b;
+            materialize(b, scratch);
+            return scratch;
+        }
+
+    }
+
+    // out(m x n) = A(m x k, CSR) * B(k x n)
+    template <typename T, MatrixOperand B>
+        requires std::same_as<T, operand_value_t<B>>
+    void sparse_matrix_product_into(const CsrMatrix<T>& a, const B& b_operand, Tensor<T, 2>& out) {
+        const TensorView<const T, 2> b(b_operand);
+        if (a.cols() != b.shape()[0]) {
+            throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        }
+        const size_t n = b.shape()[1];
+        out.reshape({a.rows(), n});
+        Tensor<T, 2> scratch(0, 0);
+        const TensorView<const T, 2> vb = detail::contiguous_rows(b, scratch);
+        detail::spmm(a.rows(), n, a.row_ptr(), a.col_idx(), a.values(),
+                     vb.data(), vb.strides()[0], out.raw_data(), n);
+    }
+
+    // out(k x n) = Aᵀ(k x m) * B(m x n), con A en CSR. Cada no nulo A(i, kk) suma la fila i
+    // de B a la fila kk de out: las columnas de A sin no nulos solo cuestan escribir ceros
+    template <typename T, MatrixOperand B>
+        requires std::same_as<T, operand_value_t<B>>
+    void sparse_matrix_product_tn_into(const CsrMatrix<T>& a, const B& b_operand, Tensor<T, 2>& out) {
+        const TensorView<const T, 2> b(b_operand);
+        if (a.rows() != b.shape()[0]) {
+            throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        }
+        const size_t n = b.shape()[1];
+        out.reshape({a.cols(), n});
+        out.fill(T(0));
+        Tensor<T, 2> scratch(0, 0);
+        const TensorView<const T, 2> vb = detail::contiguous_rows(b, scratch);
+        detail::spmm_tn(a.rows(), n, a.row_ptr(), a.col_idx(), a.values(),
+                        vb.data(), vb.strides()[0], out.raw_data(), n);
+    }
+
+}
+
+#endif // PROG3_TENSOR_FINAL_PROJECT_V2025_01_SPARSE_H
@@ -0,0 +1,241 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_STATIC_TENSOR_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_STATIC_TENSOR_H
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <initializer_list>
+#include "tensor.h"
+#include "tensor_view.h"
+
+// Tensor con forma fija en tiempo de compilación: forma, strides y tamaño son
+// constexpr, así que los bucles tienen límites constantes y el compilador los
+// desenrolla y vectoriza sin epílogos. Los tensores pequeños viven en un std::array.
+namespace utec::algebra {
+
+    // Por encima de este tamaño (bytes) los datos van al heap y no en línea
+    inline constexpr size_t static_inline_bytes = 4096;
+
+    // Matrices de hasta este número de elementos usan los kernels de tamaño fijo;
+    // con más, el GEMM empaquetado (con micro-kernels AVX) es más rápido
+    inline constexpr size_t static_kernel_max_work = 16 * 16;
+
+    namespace detail {
+
+        template <size_t... Dims>
+        constexpr std::array<size_t, sizeof...(Dims)> static_strides() {
+            std::array<size_t, sizeof...(Dims)> shape{Dims...}, strides{};
+            size_t stride = 1;
+            for (size_t i = sizeof...(Dims); i-- > 0;) {
+                strides[i] = stride;
+                stride *= shape[i];
+            }
+            return strides;
+        }
+
+        template <typename T, size_t N, bool Inline = (N * sizeof(T) <= static_inline_bytes)>
+        struct static_buffer {
+            alignas(default_alignment) std::array<T, N> values{};
+
+            T* data() noexcept { return values.data(); }
+            const T* data() const noexcept { return values.data(); }
+        };
+
+        // Tamaño fijo igualmente, pero en memoria alineada del heap
+        template <typename T, size_t N>
+        struct static_buffer<T, N, false> {
+            std::vector<T, AlignedAllocator<T>> values = std::vector<T, AlignedAllocator<T>>(N);
+
+            T* data() noexcept { return std::assume_aligned<default_alignment>(values.data()); }
+            const T* data() const noexcept { return std::assume_aligned<default_alignment>(values.data()); }
+        };
+
+    }
+
+    template <typename T, size_t... Dims>
+    class StaticTensor {
+        static_assert(sizeof...(Dims) > 0, "StaticTensor necesita al menos una dimensión");
+        static_assert(((Dims > 0) && ...), "Las dimensiones deben ser positivas");
+
+    public:
+        using value_type = T;
+        static constexpr size_t rank = sizeof...(Dims);
+        static constexpr size_t count = (Dims * ...);
+        static constexpr std::array<size_t, rank> dims{Dims...};
+        static constexpr std::array<size_t, rank> steps = detail::static_strides<Dims...>();
+        static constexpr bool is_inline = count * sizeof(T) <= static_inline_bytes;
+
+    private:
+        detail::static_buffer<T, count> buffer_;
+
+        template <size_t... I>
+        static constexpr size_t flat_index(const std::array<size_t, rank>& idxs, std::index_sequence<I...>) {
+            if constexpr (bounds_checked) {
+                if (((idxs[I] >= dims[I]) || ...)) throw std::out_of_range("Index out of bounds");
+            } else {
+                for (size_t i = 0; i < rank; ++i) UTEC_ASSUME(idxs[i] < dims[i]);
+            }
+            return ((idxs[I] * steps[I]) + ...);
+        }
+
+    public:
+        StaticTensor() = default;
+
+        StaticTensor(std::initializer_list<T> values) {
+            if (values.size() != count) {
+                throw std::invalid_argument("Data size does not match algebra size");
+            }
+            std::copy(values.begin(), values.end(), data());
+        }
+
+        template <typename Storage>
+        explicit StaticTensor(const Tensor<T, rank, Storage>& other) {
+            if (other.shape() != dims) {
+                throw std::invalid_argument("Shapes do not match");
+            }
+            std::copy(other.cbegin(), other.cend(), data());
+        }
+
+        static constexpr const std::array<size_t, rank>& shape() noexcept { return dims; }
+        static constexpr const std::array<size_t, rank>& strides() noexcept { return steps; }
+        static constexpr size_t size() noexcept { return count; }
+
+        T* data() noexcept { return buffer_.data(); }
+        const T* data() const noexcept { return buffer_.data(); }
+
+        T* begin() noexcept { return data(); }
+        T* end() noexcept { return data() + count; }
+        const T* begin() const noexcept { return data(); }
+        const T* end() const noexcept { return data() + count; }
+
+        T& operator[](size_t i) { return data()[i]; }
+        const T& operator[](size_t i) const { return data()[i]; }
+
+        template <typename... Idxs>
+        T& operator()(Idxs... idxs) {
+            static_assert(sizeof...(Idxs) == rank, "Número de índices incorrecto");
+            return data()[flat_index({static_cast<size_t>(idxs)...}, std::make_index_sequence<rank>{})];
+        }
+
+        template <typename... Idxs>
+        const T& operator()(Idxs... idxs) const {
+            static_assert(sizeof...(Idxs) == rank, "Número de índices incorrecto");
+            return data()[flat_index({static_cast<size_t>(idxs)...}, std::make_index_sequence<rank>{})];
+        }
+
+        void fill(const T& value) { std::fill_n(data(), count, value); }
+
+        StaticTensor& operator+=(const StaticTensor& other) {
+            T* a = data();
+            const T* b = other.data();
+            for (size_t i = 0; i < count; ++i) a[i] += b[i];
+            return *this;
+        }
+
+        StaticTensor& operator-=(const StaticTensor& other) {
+            T* a = data();
+            const T* b = other.data();
+            for (size_t i = 0; i < count; ++i) a[i] -= b[i];
+            return *this;
+        }
+
+        StaticTensor& operator*=(const T& scalar) {
+            T* a = data();
+            for (size_t i = 0; i < count; ++i) a[i] *= scalar;
+            return *this;
+        }
+
+        // Vistas para usar el tensor con las funciones que aceptan TensorView
+        TensorView<T, rank> view() noexcept { return {data(), dims, steps}; }
+        TensorView<const T, rank> view() const noexcept { return {data(), dims, steps}; }
+        operator TensorView<T, rank>() noexcept { return view(); }
+        operator TensorView<const T, rank>() const noexcept { return view(); }
+
+        Tensor<T, rank> to_tensor() const {
+            Tensor<T, rank> result(dims);
+            std::copy(begin(), end(), result.begin());
+            return result;
+        }
+    };
+
+    template <typename T, size_t... Dims>
+    bool operator==(const StaticTensor<T, Dims...>& a, const StaticTensor<T, Dims...>& b) {
+        return std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    namespace detail {
+
+        // Los kernels acumulan en un arreglo local de tamaño fijo: al no poder solaparse
+        // con las entradas, el compilador vectoriza el bucle interno sin comprobar alias.
+
+        // y[r, :] = b + x[r, :] · W para cada fila r (W es In x Out, b puede ser nulo)
+        template <size_t In, size_t Out, typename T>
+        void static_affine_rows(size_t rows, const T* x, size_t ldx, const T* w, const T* b, T* y) {
+            for (size_t r = 0; r < rows; ++r) {
+                const T* xr = x + r * ldx;
+                T acc[Out];
+                if (b) std::copy_n(b, Out, acc);
+                else std::fill_n(acc, Out, T(0));
+                for (size_t p = 0; p < In; ++p) {
+                    const T xv = xr[p];
+                    const T* wp = w + p * Out;
+                    for (size_t j = 0; j < Out; ++j) acc[j] += xv * wp[j];
+                }
+                std::copy_n(acc, Out, y + r * Out);
+            }
+        }
+
+        // dw (In x Out) = x^T · g
+        template <size_t In, size_t Out, typename T>
+        void static_weight_grad(size_t rows, const T* x, size_t ldx, const T* g, size_t ldg, T* dw) {
+            for (size_t p = 0; p < In; ++p) {
+                T acc[Out] = {};
+                for (size_t r = 0; r < rows; ++r) {
+                    const T xv = x[r * ldx + p];
+                    const T* gr = g + r * ldg;
+                    for (size_t j = 0; j < Out; ++j) acc[j] += xv * gr[j];
+                }
+                std::copy_n(acc, Out, dw + p * Out);
+            }
+        }
+
+        // out[r, :] = g[r, :] · W^T, con wt = W^T (Out x In) para recorrer filas contiguas
+        template <size_t In, size_t Out, typename T>
+        void static_input_grad(size_t rows, const T* g, size_t ldg, const T* wt, T* out) {
+            for (size_t r = 0; r < rows; ++r) {
+                const T* gr = g + r * ldg;
+                T acc[In] = {};
+                for (size_t j = 0; j < Out; ++j) {
+                    const T gv = gr[j];
+                    const T* wj = wt + j * In;
+                    for (size_t p = 0; p < In; ++p) acc[p] += gv * wj[p];
+                }
+                std::copy_n(acc, In, out + r * In);
+            }
+        }
+
+    }
+
+    // Producto de matrices con dimensiones fijas: el resultado también es estático
+    template <typename T, size_t M, size_t K, size_t N>
+    StaticTensor<T, M, N> matrix_product(const StaticTensor<T, M, K>& a, const StaticTensor<T, K, N>& b) {
+        StaticTensor<T, M, N> result;
+        if constexpr (K * N <= static_kernel_max_work) {
+            detail::static_affine_rows<K, N>(M, a.data(), K, b.data(), static_cast<const T*>(nullptr), result.data());
+        } else {
+            detail::gemm_strided(M, N, K, detail::as_strided(a.view()), detail::as_strided(b.view()),
+                                 result.data(), N, false);
+        }
+        return result;
+    }
+
+    template <typename T, size_t... Dims>
+    std::ostream& operator<<(std::ostream& os, const StaticTensor<T, Dims...>& tensor) {
+        return os << tensor.to_tensor();
+    }
+
+}
+
+#endif //PROG3_TENSOR_FINAL_PROJECT_V2025_01_STATIC_TENSOR_H
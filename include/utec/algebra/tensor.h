@@ -8,15 +8,102 @@
 #include <algorithm>
 #include <numeric>
 #include <iostream>
+#include <type_traits>
+#include <utility>
+#include "gemm.h"
+#include "tensor_storage.h"
+#include "transpose.h"
+
+// Comprobación de índices en operator(): activa en debug y desactivada con NDEBUG.
+// Se puede forzar definiendo UTEC_TENSOR_BOUNDS_CHECK a 0 o 1 antes de incluir.
+#ifndef UTEC_TENSOR_BOUNDS_CHECK
+#ifdef NDEBUG
+#define UTEC_TENSOR_BOUNDS_CHECK 0
+#else
+#define UTEC_TENSOR_BOUNDS_CHECK 1
+#endif
+#endif
+
+// Pista al optimizador: la condición se cumple siempre (no se evalúa en tiempo de ejecución)
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(assume)
+#define UTEC_ASSUME(cond) [[assume(cond)]]
+#endif
+#endif
+#ifndef UTEC_ASSUME
+#if defined(__clang__)
+#define UTEC_ASSUME(cond) __builtin_assume(cond)
+#elif defined(__GNUC__)
+#define UTEC_ASSUME(cond) do { if (!(cond)) __builtin_unreachable(); } while (0)
+#elif defined(_MSC_VER)
+#define UTEC_ASSUME(cond) __assume(cond)
+#else
+#define UTEC_ASSUME(cond) ((void)0)
+#endif
+#endif
 
 namespace utec {
     namespace algebra {
+        inline constexpr bool bounds_checked = UTEC_TENSOR_BOUNDS_CHECK;
+
+        // Storage elige dónde viven los datos (ver tensor_storage.h); por defecto un
+        // std::vector alineado a 64 bytes
+        template <typename T, size_t Rank, typename Storage = AlignedStorage>
+        class Tensor;
+
+        // Tensor pequeño en línea (bias, estados de Adam, escalares): sin memoria del heap
         template <typename T, size_t Rank>
+        using SmallTensor = Tensor<T, Rank, SmallStorage<>>;
+
+        // Base CRTP de las expresiones perezosas: nada se calcula hasta asignarlas a un Tensor
+        template <typename E>
+        struct TensorExpr {
+            const E& self() const noexcept { return static_cast<const E&>(*this); }
+        };
+
+        template <typename TensorType, bool Owned>
+        class TensorLeaf;
+
+        namespace detail {
+
+            template <typename X>
+            struct tensor_traits : std::false_type {};
+
+            template <typename T, size_t Rank, typename Storage>
+            struct tensor_traits<Tensor<T, Rank, Storage>> : std::true_type {
+                using value_type = T;
+                static constexpr size_t rank = Rank;
+            };
+
+            template <size_t Rank>
+            std::array<size_t, Rank> broadcast_shape(const std::array<size_t, Rank>& a,
+                                                     const std::array<size_t, Rank>& b) {
+                std::array<size_t, Rank> result_shape;
+                for (size_t i = 0; i < Rank; ++i) {
+                    if (a[i] == b[i]) {
+                        result_shape[i] = a[i];
+                    } else if (a[i] == 1) {
+                        result_shape[i] = b[i];
+                    } else if (b[i] == 1) {
+                        result_shape[i] = a[i];
+                    } else {
+                        throw std::invalid_argument("Shapes do not match and they are not compatible for broadcasting");
+                    }
+                }
+                return result_shape;
+            }
+
+        }
+
+        template <typename T, size_t Rank, typename Storage>
         class Tensor {
+        public:
+            using storage_type = typename Storage::template container<T>;
+
         private:
             std::array<size_t, Rank> shapes;
             std::array<size_t, Rank> strides;
-            std::vector<T> data;
+            storage_type data;
 
             void compute_strides() {
                 if (Rank == 0) return;
@@ -32,7 +119,7 @@ namespace utec {
                 return std::accumulate(shapes.begin(), shapes.end(), size_t{1}, std::multiplies<>());
             }
 
-            size_t get_flat_index(const std::array<size_t, Rank>& idxs) const {
+            size_t checked_flat_index(const std::array<size_t, Rank>& idxs) const {
                 size_t flat = 0;
                 for (size_t i = 0; i < Rank; ++i) {
                     if (idxs[i] >= shapes[i]) throw std::out_of_range("Index out of bounds");
@@ -41,72 +128,89 @@ namespace utec {
                 return flat;
             }
 
+            // Sin comprobación, el acceso queda en una suma de productos que el
+            // compilador puede vectorizar dentro de los bucles de las capas
+            size_t get_flat_index(const std::array<size_t, Rank>& idxs) const {
+                if constexpr (bounds_checked) {
+                    return checked_flat_index(idxs);
+                } else {
+                    size_t flat = 0;
+                    for (size_t i = 0; i < Rank; ++i) {
+                        UTEC_ASSUME(idxs[i] < shapes[i]);
+                        flat += idxs[i] * strides[i];
+                    }
+                    return flat;
+                }
+            }
+
             size_t calculateTotalSize(const std::array<size_t, Rank>& shape) const {
                 size_t total = 1;
                 for (size_t dim : shape) total *= dim;
                 return total;
             }
 
-            std::array<size_t, Rank> calculateBroadcastShape(const Tensor& other) const {
-                std::array<size_t, Rank> result_shape;
-                for (size_t i = 0; i < Rank; ++i) {
-                    if (shapes[i] == other.shapes[i]) {
-                        result_shape[i] = shapes[i];
-                    } else if (shapes[i] == 1) {
-                        result_shape[i] = other.shapes[i];
-                    } else if (other.shapes[i] == 1) {
-                        result_shape[i] = shapes[i];
-                    } else {
-                        throw std::invalid_argument("Shapes do not match and they are not compatible for broadcasting");
-                    }
+            // Recorre la expresión una sola vez aplicando store(destino, valor).
+            // Sin broadcast el bucle es plano; con broadcast se avanza fila a fila:
+            // cada hoja calcula el inicio de su fila con strides nulos en las
+            // dimensiones difundidas y la recorre con paso 1 (o 0 si difunde la última)
+            template<typename E, typename Store>
+            void walk(const E& expr, Store store) {
+                T* out = data.data();
+                const size_t total = data.size();
+                if (expr.shape() == shapes && expr.is_dense()) {
+                    for (size_t i = 0; i < total; ++i) store(out[i], expr[i]);
+                    return;
                 }
-                return result_shape;
-            }
-
-            template<typename BinaryOp>
-            Tensor applyBinaryOperation(const Tensor& other, BinaryOp op) const {
-                auto result_shape = calculateBroadcastShape(other);
-                Tensor result(result_shape);
+                if (total == 0) return;
 
-                size_t total_size = result.data.size();
-                for (size_t flat_idx = 0; flat_idx < total_size; ++flat_idx) {
-                    auto idxs = result.multiIndex(flat_idx);
-
-                    std::array<size_t, Rank> idx_a, idx_b;
-                    for (size_t i = 0; i < Rank; ++i) {
-                        idx_a[i] = (shapes[i] == 1) ? 0 : idxs[i];
-                        idx_b[i] = (other.shapes[i] == 1) ? 0 : idxs[i];
+                const size_t inner = shapes[Rank - 1];
+                const bool contiguous = expr.inner_contiguous(inner);
+                std::array<size_t, Rank> idxs{};
+                for (T* row_out = out; row_out != out + total; row_out += inner) {
+                    if (contiguous) {
+                        auto row = expr.template row<true>(idxs);
+                        for (size_t j = 0; j < inner; ++j) store(row_out[j], row[j]);
+                    } else {
+                        auto row = expr.template row<false>(idxs);
+                        for (size_t j = 0; j < inner; ++j) store(row_out[j], row[j]);
+                    }
+                    for (size_t d = Rank - 1; d-- > 0;) {
+                        if (++idxs[d] < shapes[d]) break;
+                        idxs[d] = 0;
                     }
-
-                    result.data[flat_idx] = op((*this)(idx_a), other(idx_b));
                 }
+            }
 
-                return result;
+            template<typename E>
+            void evaluate(const E& expr) {
+                walk(expr, [](T& dst, const T& val) { dst = val; });
             }
 
-            template<typename UnaryOp>
-            Tensor applyScalarOperation(const T& scalar, UnaryOp op) const {
-                Tensor result = *this;
-                for (auto& val : result.data) {
-                    val = op(val, scalar);
+            // expr debe poder difundirse (broadcast) sobre la forma de *this
+            template<typename E, typename BinaryOp>
+            Tensor& applyInPlace(const E& expr, BinaryOp op) {
+                if (detail::broadcast_shape(shapes, expr.shape()) != shapes) {
+                    throw std::invalid_argument("Shapes do not match and they are not compatible for broadcasting");
                 }
-                return result;
+                walk(expr, [op](T& dst, const T& val) { dst = op(dst, val); });
+                return *this;
             }
 
         public:
             Tensor() {
                 shapes.fill(1);
                 compute_strides();
-                data.resize(1, T{});
+                data.resize(1);
             }
 
             Tensor(const std::array<size_t, Rank>& shape) : shapes(shape) {
                 compute_strides();
                 size_t total_elements = total_size();
-                data.resize(total_elements, T{});
+                data.resize(total_elements);
             }
 
             template <typename... Dims>
+                requires (std::is_convertible_v<Dims, size_t> && ...)
             Tensor(Dims... dims) {
                 if (sizeof...(dims) != Rank) {
                     throw std::invalid_argument("Number of dimensions do not match with " + std::to_string(Rank));
@@ -114,7 +218,7 @@ namespace utec {
                 shapes = {static_cast<size_t>(dims)...};
                 compute_strides();
                 size_t total_elements = total_size();
-                data.resize(total_elements, T{});
+                data.resize(total_elements);
             }
 
             template <typename... Dims>
@@ -128,7 +232,7 @@ namespace utec {
                 if (values.size() != total_elements) {
                     throw std::invalid_argument("Number of values does not match algebra size");
                 }
-                data = std::vector<T>(values);
+                data.assign(values.begin(), values.end());
             }
 
             Tensor& operator=(std::initializer_list<T> values) {
@@ -139,6 +243,17 @@ namespace utec {
                 return *this;
             }
 
+            // Adopta un almacenamiento ya construido (p. ej. un ExternalBuffer) sin copiarlo
+            Tensor(const std::array<size_t, Rank>& shape, storage_type storage)
+                : shapes(shape), data(std::move(storage)) {
+                compute_strides();
+                data.resize(calculateTotalSize(shapes));
+            }
+
+            Tensor(const Tensor& other) = default;
+            Tensor(Tensor&& other) noexcept = default;
+
+            // Reutiliza la capacidad de data si alcanza: no reserva memoria nueva
             Tensor& operator=(const Tensor& other) {
                 if (this != &other) {
                     shapes = other.shapes;
@@ -148,6 +263,27 @@ namespace utec {
                 return *this;
             }
 
+            Tensor& operator=(Tensor&& other) noexcept = default;
+
+            template <typename E>
+            Tensor(const TensorExpr<E>& expr) : shapes(expr.self().shape()) {
+                compute_strides();
+                data.resize(calculateTotalSize(shapes));
+                evaluate(expr.self());
+            }
+
+            // Si la forma no cambia se escribe en sitio: cada elemento se lee antes de
+            // sobrescribirse, así que *this puede aparecer en la propia expresión
+            template <typename E>
+            Tensor& operator=(const TensorExpr<E>& expr) {
+                if (expr.self().shape() != shapes) {
+                    return *this = Tensor(expr);
+                }
+                data.resize(calculateTotalSize(shapes));
+                evaluate(expr.self());
+                return *this;
+            }
+
             template <typename... Idxs>
             T& operator()(Idxs... idxs) {
                 static_assert(sizeof...(Idxs) == Rank, "Número de índices incorrecto");
@@ -162,9 +298,25 @@ namespace utec {
                 return data[get_flat_index(idx_array)];
             }
 
+            // Acceso siempre comprobado, con o sin NDEBUG
+            template <typename... Idxs>
+            T& at(Idxs... idxs) {
+                static_assert(sizeof...(Idxs) == Rank, "Número de índices incorrecto");
+                return data[checked_flat_index({static_cast<size_t>(idxs)...})];
+            }
+
+            template <typename... Idxs>
+            const T& at(Idxs... idxs) const {
+                static_assert(sizeof...(Idxs) == Rank, "Número de índices incorrecto");
+                return data[checked_flat_index({static_cast<size_t>(idxs)...})];
+            }
+
             T& operator[](size_t i) { return data[i]; }
             const T& operator[](size_t i) const { return data[i]; }
 
+            T* raw_data() noexcept { return data.data(); }
+            const T* raw_data() const noexcept { return data.data(); }
+
             T& operator()(const std::array<size_t, Rank>& idxs) {
                 return data[get_flat_index(idxs)];
             }
@@ -185,12 +337,13 @@ namespace utec {
                 return num_elements();
             }
 
+            // Conserva la capacidad reservada: reducir y volver a crecer no reserva memoria
             void reshape(const std::array<size_t, Rank>& new_shape) {
-                size_t new_total = total_size();
+                size_t new_total = calculateTotalSize(new_shape);
                 size_t old_total = data.size();
 
                 if (new_total != old_total) {
-                    data.resize(new_total, T{});
+                    data.resize(new_total);
                 }
 
                 shapes = new_shape;
@@ -207,33 +360,63 @@ namespace utec {
                 std::fill(data.begin(), data.end(), value);
             }
 
-            Tensor operator+(const Tensor& other) const {
-                return applyBinaryOperation(other, [](const T& a, const T& b) { return a + b; });
+            Tensor& operator+=(const Tensor& other) {
+                return applyInPlace(TensorLeaf<Tensor, false>(other), std::plus<>());
+            }
+
+            Tensor& operator-=(const Tensor& other) {
+                return applyInPlace(TensorLeaf<Tensor, false>(other), std::minus<>());
+            }
+
+            Tensor& operator*=(const Tensor& other) {
+                return applyInPlace(TensorLeaf<Tensor, false>(other), std::multiplies<>());
             }
 
-            Tensor operator-(const Tensor& other) const {
-                return applyBinaryOperation(other, [](const T& a, const T& b) { return a - b; });
+            // Operando con otra política de almacenamiento (p. ej. un bias en SmallStorage)
+            template <typename OtherStorage>
+            Tensor& operator+=(const Tensor<T, Rank, OtherStorage>& other) {
+                return applyInPlace(TensorLeaf<Tensor<T, Rank, OtherStorage>, false>(other), std::plus<>());
             }
 
-            Tensor operator*(const Tensor& other) const {
-                return applyBinaryOperation(other, [](const T& a, const T& b) { return a * b; });
+            template <typename OtherStorage>
+            Tensor& operator-=(const Tensor<T, Rank, OtherStorage>& other) {
+                return applyInPlace(TensorLeaf<Tensor<T, Rank, OtherStorage>, false>(other), std::minus<>());
             }
 
-            Tensor operator+(const T& scalar) const {
-                return applyScalarOperation(scalar, [](const T& val, const T& s) { return val + s; });
+            template <typename E>
+            Tensor& operator+=(const TensorExpr<E>& expr) {
+                return applyInPlace(expr.self(), std::plus<>());
             }
 
-            Tensor operator-(const T& scalar) const {
-                return applyScalarOperation(scalar, [](const T& val, const T& s) { return val - s; });
+            template <typename E>
+            Tensor& operator-=(const TensorExpr<E>& expr) {
+                return applyInPlace(expr.self(), std::minus<>());
             }
 
-            Tensor operator*(const T& scalar) const {
-                return applyScalarOperation(scalar, [](const T& val, const T& s) { return val * s; });
+            template <typename E>
+            Tensor& operator*=(const TensorExpr<E>& expr) {
+                return applyInPlace(expr.self(), std::multiplies<>());
             }
 
-            Tensor operator/(const T& scalar) const {
+            Tensor& operator+=(const T& scalar) {
+                for (auto& val : data) val += scalar;
+                return *this;
+            }
+
+            Tensor& operator-=(const T& scalar) {
+                for (auto& val : data) val -= scalar;
+                return *this;
+            }
+
+            Tensor& operator*=(const T& scalar) {
+                for (auto& val : data) val *= scalar;
+                return *this;
+            }
+
+            Tensor& operator/=(const T& scalar) {
                 if (scalar == 0) throw std::invalid_argument("División por cero");
-                return applyScalarOperation(scalar, [](const T& val, const T& s) { return val / s; });
+                for (auto& val : data) val /= scalar;
+                return *this;
             }
 
             template<typename UnaryOp>
@@ -246,7 +429,7 @@ namespace utec {
             }
 
             size_t linearIndex(const std::array<size_t, Rank>& idxs) const {
-                return get_flat_index(idxs);
+                return checked_flat_index(idxs);
             }
 
             std::array<size_t, Rank> multiIndex(size_t linear_idx) const {
@@ -278,38 +461,84 @@ namespace utec {
             }
         };
 
+        // Con Rank > 2 multiplica cada matriz del lote (las dos últimas dimensiones) en una
+        // sola llamada a gemm_batched. Las dimensiones iniciales deben coincidir, o ser todas 1
+        // en uno de los operandos para compartirlo con todo el lote.
         template <typename T, size_t Rank>
         Tensor<T, Rank> matrix_product(const Tensor<T, Rank>& a, const Tensor<T, Rank>& b) {
             static_assert(Rank >= 2, "matrix_product requiere tensores de al menos 2 dimensiones");
 
             const auto& shape_a = a.shape();
             const auto& shape_b = b.shape();
+            const size_t m = shape_a[Rank - 2], k = shape_a[Rank - 1], n = shape_b[Rank - 1];
 
-            if (shape_a[1] != shape_b[0]) {
+            if (k != shape_b[Rank - 2]) {
                 throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
             }
 
-            std::array<size_t, Rank> result_shape = {shape_a[0], shape_b[1]};
+            size_t batch_a = 1, batch_b = 1;
+            for (size_t d = 0; d + 2 < Rank; ++d) {
+                batch_a *= shape_a[d];
+                batch_b *= shape_b[d];
+            }
+            const bool same_batch = std::equal(shape_a.begin(), shape_a.end() - 2, shape_b.begin());
+            if (!same_batch && batch_a != 1 && batch_b != 1) {
+                throw std::invalid_argument("Batch dimensions do not match for matrix multiplication");
+            }
+
+            std::array<size_t, Rank> result_shape = batch_a == 1 ? shape_b : shape_a;
+            result_shape[Rank - 2] = m;
+            result_shape[Rank - 1] = n;
             Tensor<T, Rank> result(result_shape);
-            result.fill(T{});
 
-            for (size_t i = 0; i < shape_a[0]; ++i) {
-                for (size_t j = 0; j < shape_b[1]; ++j) {
-                    for (size_t k = 0; k < shape_a[1]; ++k) {
-                        result(i, j) += a(i, k) * b(k, j);
-                    }
-                }
+            gemm_batched(std::max(batch_a, batch_b), m, n, k,
+                         a.raw_data(), k, batch_a == 1 ? 0 : m * k,
+                         b.raw_data(), n, batch_b == 1 ? 0 : k * n,
+                         result.raw_data(), n, m * n);
+
+            return result;
+        }
+
+        // a^T * b sin construir la transpuesta de a
+        template <typename T>
+        Tensor<T, 2> matrix_product_tn(const Tensor<T, 2>& a, const Tensor<T, 2>& b) {
+            const auto& shape_a = a.shape();
+            const auto& shape_b = b.shape();
+
+            if (shape_a[0] != shape_b[0]) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+
+            Tensor<T, 2> result(shape_a[1], shape_b[1]);
+            gemm_tn(shape_a[1], shape_b[1], shape_a[0],
+                    a.raw_data(), shape_a[1],
+                    b.raw_data(), shape_b[1],
+                    result.raw_data(), shape_b[1]);
+            return result;
+        }
+
+        // a * b^T sin construir la transpuesta de b
+        template <typename T>
+        Tensor<T, 2> matrix_product_nt(const Tensor<T, 2>& a, const Tensor<T, 2>& b) {
+            const auto& shape_a = a.shape();
+            const auto& shape_b = b.shape();
+
+            if (shape_a[1] != shape_b[1]) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
             }
 
+            Tensor<T, 2> result(shape_a[0], shape_b[0]);
+            gemm_nt(shape_a[0], shape_b[0], shape_a[1],
+                    a.raw_data(), shape_a[1],
+                    b.raw_data(), shape_b[1],
+                    result.raw_data(), shape_b[0]);
             return result;
         }
 
+        // Transpone las dos últimas dimensiones; con Rank > 2 cada matriz del lote por separado
         template <typename T, size_t Rank>
         Tensor<T, Rank> transpose_2d(const Tensor<T, Rank>& matrix) {
-            if (Rank < 2) {
-                std::cout << "Cannot transpose 1D algebra: need at least 2 dimensions" << std::endl;
-                return matrix;
-            }
+            static_assert(Rank >= 2, "transpose_2d requiere tensores de al menos 2 dimensiones");
 
             const auto& shape = matrix.shape();
             std::array<size_t, Rank> new_shape = shape;
@@ -317,37 +546,272 @@ namespace utec {
 
             Tensor<T, Rank> result(new_shape);
 
-            for (size_t i = 0; i < shape[0]; ++i) {
-                for (size_t j = 0; j < shape[1]; ++j) {
-                    result(j, i) = matrix(i, j);
-                }
+            const size_t rows = shape[Rank - 2];
+            const size_t cols = shape[Rank - 1];
+            const size_t step = rows * cols;
+            for (size_t offset = 0; step > 0 && offset < matrix.size(); offset += step) {
+                transpose(rows, cols, matrix.raw_data() + offset, cols, result.raw_data() + offset, rows);
             }
 
             return result;
         }
 
-        template<typename T, size_t Rank>
-        Tensor<T, Rank> operator+(const T& scalar, const Tensor<T, Rank>& tensor) {
-            return tensor + scalar;
-        }
+        // Variante en sitio: las dos últimas dimensiones deben ser iguales
+        template <typename T, size_t Rank, typename Storage>
+        void transpose_2d_inplace(Tensor<T, Rank, Storage>& matrix) {
+            static_assert(Rank >= 2, "transpose_2d_inplace requiere tensores de al menos 2 dimensiones");
+
+            const auto& shape = matrix.shape();
+            if (shape[Rank - 1] != shape[Rank - 2]) {
+                throw std::invalid_argument("In-place transpose requires square matrices");
+            }
 
-        template<typename T, size_t Rank>
-        Tensor<T, Rank> operator-(const T& scalar, const Tensor<T, Rank>& tensor) {
-            Tensor<T, Rank> result(tensor.shape());
-            auto tensor_it = tensor.cbegin();
-            for (auto& val : result) {
-                val = scalar - *tensor_it++;
+            const size_t n = shape[Rank - 1];
+            const size_t step = n * n;
+            for (size_t offset = 0; step > 0 && offset < matrix.size(); offset += step) {
+                transpose_inplace(n, matrix.raw_data() + offset, n);
             }
+        }
+
+        // Copia con otro tipo de elemento (p. ej. float <-> bf16) usando la conversión por bloques
+        template <typename U, typename T, size_t Rank, typename Storage>
+        Tensor<U, Rank> tensor_cast(const Tensor<T, Rank, Storage>& tensor) {
+            Tensor<U, Rank> result(tensor.shape());
+            convert(tensor.raw_data(), result.raw_data(), tensor.size());
             return result;
         }
 
-        template<typename T, size_t Rank>
-        Tensor<T, Rank> operator*(const T& scalar, const Tensor<T, Rank>& tensor) {
-            return tensor * scalar;
+        // Hoja de una expresión: referencia a un tensor lvalue, o el tensor mismo si
+        // era un temporal (se mueve dentro de la expresión para que no quede colgando)
+        template <typename TensorType, bool Owned>
+        class TensorLeaf : public TensorExpr<TensorLeaf<TensorType, Owned>> {
+        public:
+            using value_type = typename detail::tensor_traits<TensorType>::value_type;
+            static constexpr size_t rank = detail::tensor_traits<TensorType>::rank;
+
+        private:
+            using T = value_type;
+            static constexpr size_t Rank = rank;
+
+            std::conditional_t<Owned, TensorType, const TensorType&> tensor_;
+            // Strides con 0 en las dimensiones de tamaño 1 (las que se difunden)
+            std::array<size_t, Rank> strides_{};
+
+            void compute_broadcast_strides() {
+                const auto& shape = tensor_.shape();
+                size_t stride = 1;
+                for (size_t d = Rank; d-- > 0;) {
+                    strides_[d] = shape[d] == 1 ? 0 : stride;
+                    stride *= shape[d];
+                }
+            }
+
+        public:
+            template <bool Contiguous>
+            struct Row {
+                const T* ptr;
+                size_t stride;
+                T operator[](size_t j) const {
+                    if constexpr (Contiguous) return ptr[j];
+                    else return ptr[j * stride];
+                }
+            };
+
+            explicit TensorLeaf(const TensorType& tensor) requires (!Owned) : tensor_(tensor) {
+                compute_broadcast_strides();
+            }
+            explicit TensorLeaf(TensorType&& tensor) requires Owned : tensor_(std::move(tensor)) {
+                compute_broadcast_strides();
+            }
+
+            const std::array<size_t, Rank>& shape() const noexcept { return tensor_.shape(); }
+            bool is_dense() const noexcept { return true; }
+            bool inner_contiguous(size_t inner) const noexcept { return tensor_.shape()[Rank - 1] == inner; }
+
+            T operator[](size_t i) const { return tensor_.raw_data()[i]; }
+
+            template <bool Contiguous>
+            Row<Contiguous> row(const std::array<size_t, Rank>& idxs) const {
+                size_t offset = 0;
+                for (size_t d = 0; d + 1 < Rank; ++d) offset += idxs[d] * strides_[d];
+                return {tensor_.raw_data() + offset, strides_[Rank - 1]};
+            }
+        };
+
+        template <typename L, typename R, typename Op>
+        class BinaryExpr : public TensorExpr<BinaryExpr<L, R, Op>> {
+        public:
+            using value_type = typename L::value_type;
+            static constexpr size_t rank = L::rank;
+
+        private:
+            static_assert(std::is_same_v<value_type, typename R::value_type>, "Operandos con tipos de elemento distintos");
+            static_assert(rank == R::rank, "Operandos con distinto número de dimensiones");
+
+            L lhs_;
+            R rhs_;
+            std::array<size_t, rank> shape_;
+            bool dense_;
+
+        public:
+            BinaryExpr(L lhs, R rhs)
+                : lhs_(std::move(lhs)), rhs_(std::move(rhs)),
+                  shape_(detail::broadcast_shape(lhs_.shape(), rhs_.shape())),
+                  dense_(lhs_.is_dense() && rhs_.is_dense() &&
+                         lhs_.shape() == shape_ && rhs_.shape() == shape_) {}
+
+            template <bool Contiguous>
+            struct Row {
+                typename L::template Row<Contiguous> lhs;
+                typename R::template Row<Contiguous> rhs;
+                value_type operator[](size_t j) const { return Op{}(lhs[j], rhs[j]); }
+            };
+
+            const std::array<size_t, rank>& shape() const noexcept { return shape_; }
+            bool is_dense() const noexcept { return dense_; }
+            bool inner_contiguous(size_t inner) const noexcept {
+                return lhs_.inner_contiguous(inner) && rhs_.inner_contiguous(inner);
+            }
+
+            value_type operator[](size_t i) const { return Op{}(lhs_[i], rhs_[i]); }
+
+            template <bool Contiguous>
+            Row<Contiguous> row(const std::array<size_t, rank>& idxs) const {
+                return {lhs_.template row<Contiguous>(idxs), rhs_.template row<Contiguous>(idxs)};
+            }
+        };
+
+        // Operación con un escalar; ScalarLeft indica `escalar op expr`
+        template <typename E, typename Op, bool ScalarLeft>
+        class ScalarExpr : public TensorExpr<ScalarExpr<E, Op, ScalarLeft>> {
+        public:
+            using value_type = typename E::value_type;
+            static constexpr size_t rank = E::rank;
+
+        private:
+            E expr_;
+            value_type scalar_;
+
+            static value_type combine(const value_type& scalar, const value_type& val) {
+                if constexpr (ScalarLeft) return Op{}(scalar, val);
+                else return Op{}(val, scalar);
+            }
+
+        public:
+            template <bool Contiguous>
+            struct Row {
+                typename E::template Row<Contiguous> inner;
+                value_type scalar;
+                value_type operator[](size_t j) const { return combine(scalar, inner[j]); }
+            };
+
+            ScalarExpr(E expr, const value_type& scalar) : expr_(std::move(expr)), scalar_(scalar) {}
+
+            const std::array<size_t, rank>& shape() const noexcept { return expr_.shape(); }
+            bool is_dense() const noexcept { return expr_.is_dense(); }
+            bool inner_contiguous(size_t inner) const noexcept { return expr_.inner_contiguous(inner); }
+
+            value_type operator[](size_t i) const { return combine(scalar_, expr_[i]); }
+
+            template <bool Contiguous>
+            Row<Contiguous> row(const std::array<size_t, rank>& idxs) const {
+                return {expr_.template row<Contiguous>(idxs), scalar_};
+            }
+        };
+
+        namespace detail {
+
+            template <typename X>
+            auto as_expr(X&& x) {
+                using D = std::remove_cvref_t<X>;
+                if constexpr (tensor_traits<D>::value) {
+                    constexpr bool owned = !std::is_lvalue_reference_v<X> && !std::is_const_v<std::remove_reference_t<X>>;
+                    return TensorLeaf<D, owned>(std::forward<X>(x));
+                } else {
+                    return D(std::forward<X>(x));
+                }
+            }
+
+            template <typename X>
+            using expr_t = decltype(as_expr(std::declval<X>()));
+
+        }
+
+        // Tensor o expresión perezosa
+        template <typename X>
+        concept TensorExpression = detail::tensor_traits<std::remove_cvref_t<X>>::value ||
+                                   std::is_base_of_v<TensorExpr<std::remove_cvref_t<X>>, std::remove_cvref_t<X>>;
+
+        template <typename X>
+        using expr_value_t = typename detail::expr_t<X>::value_type;
+
+        namespace detail {
+
+            template <typename Op, typename L, typename R>
+            auto make_binary(L&& lhs, R&& rhs) {
+                return BinaryExpr<expr_t<L>, expr_t<R>, Op>(as_expr(std::forward<L>(lhs)), as_expr(std::forward<R>(rhs)));
+            }
+
+            template <typename Op, bool ScalarLeft, typename X>
+            auto make_scalar(X&& x, const expr_value_t<X>& scalar) {
+                return ScalarExpr<expr_t<X>, Op, ScalarLeft>(as_expr(std::forward<X>(x)), scalar);
+            }
+
         }
 
-        template <typename T, size_t Rank>
-        std::ostream& operator<<(std::ostream& os, const Tensor<T, Rank>& tensor) {
+        template <TensorExpression L, TensorExpression R>
+        auto operator+(L&& lhs, R&& rhs) {
+            return detail::make_binary<std::plus<>>(std::forward<L>(lhs), std::forward<R>(rhs));
+        }
+
+        template <TensorExpression L, TensorExpression R>
+        auto operator-(L&& lhs, R&& rhs) {
+            return detail::make_binary<std::minus<>>(std::forward<L>(lhs), std::forward<R>(rhs));
+        }
+
+        template <TensorExpression L, TensorExpression R>
+        auto operator*(L&& lhs, R&& rhs) {
+            return detail::make_binary<std::multiplies<>>(std::forward<L>(lhs), std::forward<R>(rhs));
+        }
+
+        template <TensorExpression X>
+        auto operator+(X&& x, const expr_value_t<X>& scalar) {
+            return detail::make_scalar<std::plus<>, false>(std::forward<X>(x), scalar);
+        }
+
+        template <TensorExpression X>
+        auto operator-(X&& x, const expr_value_t<X>& scalar) {
+            return detail::make_scalar<std::minus<>, false>(std::forward<X>(x), scalar);
+        }
+
+        template <TensorExpression X>
+        auto operator*(X&& x, const expr_value_t<X>& scalar) {
+            return detail::make_scalar<std::multiplies<>, false>(std::forward<X>(x), scalar);
+        }
+
+        template <TensorExpression X>
+        auto operator/(X&& x, const expr_value_t<X>& scalar) {
+            if (scalar == 0) throw std::invalid_argument("División por cero");
+            return detail::make_scalar<std::divides<>, false>(std::forward<X>(x), scalar);
+        }
+
+        template <TensorExpression X>
+        auto operator+(const expr_value_t<X>& scalar, X&& x) {
+            return detail::make_scalar<std::plus<>, true>(std::forward<X>(x), scalar);
+        }
+
+        template <TensorExpression X>
+        auto operator-(const expr_value_t<X>& scalar, X&& x) {
+            return detail::make_scalar<std::minus<>, true>(std::forward<X>(x), scalar);
+        }
+
+        template <TensorExpression X>
+        auto operator*(const expr_value_t<X>& scalar, X&& x) {
+            return detail::make_scalar<std::multiplies<>, true>(std::forward<X>(x), scalar);
+        }
+
+        template <typename T, size_t Rank, typename Storage>
+        std::ostream& operator<<(std::ostream& os, const Tensor<T, Rank, Storage>& tensor) {
             const auto& shape = tensor.shape();
 
             if (Rank == 1) {
@@ -388,6 +852,15 @@ namespace utec {
             return os;
         }
 
+        // Tensor sobre memoria ajena, sin copiarla.
+        // ptr debe tener al menos tantos elementos como indica shape y sobrevivir al tensor.
+        template <typename T, size_t Rank>
+        Tensor<T, Rank, ExternalStorage> adopt_buffer(T* ptr, const std::array<size_t, Rank>& shape) {
+            size_t total = 1;
+            for (size_t dim : shape) total *= dim;
+            return Tensor<T, Rank, ExternalStorage>(shape, ExternalBuffer<T>(ptr, total));
+        }
+
         template<typename T, size_t Rank, typename UnaryOp>
         Tensor<T, Rank> apply(const Tensor<T, Rank>& tensor, UnaryOp op) {
             return tensor.apply(op);
@@ -0,0 +1,290 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_TENSOR_STORAGE_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_TENSOR_STORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Bytes que SmallStorage<> guarda en línea antes de recurrir al heap.
+// Se puede cambiar definiendo UTEC_TENSOR_INLINE_BYTES antes de incluir.
+#ifndef UTEC_TENSOR_INLINE_BYTES
+#define UTEC_TENSOR_INLINE_BYTES 256
+#endif
+
+namespace utec::algebra {
+
+    // Una línea de caché: basta para cargas alineadas de AVX-512
+    inline constexpr size_t default_alignment = 64;
+
+    template <typename T, size_t Alignment = default_alignment>
+    struct AlignedAllocator {
+        static_assert((Alignment & (Alignment - 1)) == 0, "La alineación debe ser potencia de 2");
+
+        using value_type = T;
+
+        template <typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() noexcept = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T* allocate(size_t n) {
+            if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_array_new_length();
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* p, size_t) noexcept {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    };
+
+    // Bloques de al menos una página grande (2 MiB) van a memoria anónima alineada a
+    // 2 MiB y marcada con MADV_HUGEPAGE: menos fallos de TLB en activaciones grandes.
+    // Los bloques pequeños usan AlignedAllocator.
+    template <typename T>
+    struct HugePageAllocator {
+        using value_type = T;
+
+        static constexpr size_t huge_page_size = size_t{2} << 20;
+
+        HugePageAllocator() noexcept = default;
+
+        template <typename U>
+        HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+        T* allocate(size_t n) {
+            if (n > (static_cast<size_t>(-1) - 2 * huge_page_size) / sizeof(T)) throw std::bad_array_new_length();
+            const size_t bytes = n * sizeof(T);
+            if (bytes < huge_page_size) return AlignedAllocator<T>().allocate(n);
+#ifdef __linux__
+            const size_t len = round_up(bytes);
+            void* mem = mmap(nullptr, len + huge_page_size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mem == MAP_FAILED) throw std::bad_alloc();
+            // Se reserva una página grande de más y se recortan los extremos para alinear
+            char* raw = static_cast<char*>(mem);
+            char* aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(raw)));
+            if (aligned != raw) munmap(raw, aligned - raw);
+            const size_t tail = (raw + len + huge_page_size) - (aligned + len);
+            if (tail > 0) munmap(aligned + len, tail);
+            madvise(aligned, len, MADV_HUGEPAGE);
+            return reinterpret_cast<T*>(aligned);
+#else
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(huge_page_size)));
+#endif
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            const size_t bytes = n * sizeof(T);
+            if (bytes < huge_page_size) {
+                AlignedAllocator<T>().deallocate(p, n);
+                return;
+            }
+#ifdef __linux__
+            munmap(p, round_up(bytes));
+#else
+            ::operator delete(p, std::align_val_t(huge_page_size));
+#endif
+        }
+
+        template <typename U>
+        bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+
+    private:
+        static constexpr size_t round_up(size_t bytes) {
+            return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+        }
+    };
+
+    // Buffer ajeno adoptado sin copia (p. ej. memoria de otra biblioteca o un mmap).
+    // No reserva ni libera: puede encogerse y volver a crecer hasta su capacidad.
+    // Es solo movible, para que dos tensores no escriban el mismo buffer sin saberlo.
+    template <typename T>
+    class ExternalBuffer {
+        T* ptr_ = nullptr;
+        size_t size_ = 0;
+        size_t capacity_ = 0;
+
+    public:
+        using value_type = T;
+
+        ExternalBuffer() = default;
+        ExternalBuffer(T* ptr, size_t capacity) : ptr_(ptr), size_(capacity), capacity_(capacity) {}
+
+        ExternalBuffer(const ExternalBuffer&) = delete;
+        ExternalBuffer& operator=(const ExternalBuffer&) = delete;
+
+        ExternalBuffer(ExternalBuffer&& other) noexcept
+            : ptr_(std::exchange(other.ptr_, nullptr)),
+              size_(std::exchange(other.size_, 0)),
+              capacity_(std::exchange(other.capacity_, 0)) {}
+
+        ExternalBuffer& operator=(ExternalBuffer&& other) noexcept {
+            ptr_ = std::exchange(other.ptr_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            return *this;
+        }
+
+        size_t size() const noexcept { return size_; }
+        size_t capacity() const noexcept { return capacity_; }
+        T* data() noexcept { return ptr_; }
+        const T* data() const noexcept { return ptr_; }
+
+        T& operator[](size_t i) { return ptr_[i]; }
+        const T& operator[](size_t i) const { return ptr_[i]; }
+
+        T* begin() noexcept { return ptr_; }
+        T* end() noexcept { return ptr_ + size_; }
+        const T* begin() const noexcept { return ptr_; }
+        const T* end() const noexcept { return ptr_ + size_; }
+        const T* cbegin() const noexcept { return ptr_; }
+        const T* cend() const noexcept { return ptr_ + size_; }
+
+        void resize(size_t n, const T& value = T{}) {
+            if (n > capacity_) throw std::length_error("External buffer is too small");
+            if (n > size_) std::fill(ptr_ + size_, ptr_ + n, value);
+            size_ = n;
+        }
+
+        template <typename It>
+        void assign(It first, It last) {
+            const size_t n = static_cast<size_t>(std::distance(first, last));
+            if (n > capacity_) throw std::length_error("External buffer is too small");
+            std::copy(first, last, ptr_);
+            size_ = n;
+        }
+    };
+
+    // Vector con búfer en línea: hasta N elementos no toca el allocator (bias, escalares,
+    // temporales 1xN). Al superar N pasa a memoria alineada del heap y se queda ahí, como
+    // la capacidad de std::vector, para que encoger y volver a crecer reutilice el buffer.
+    template <typename T, size_t N>
+    class SmallBuffer {
+        static_assert(N > 0, "La capacidad en línea debe ser positiva");
+
+        // Sin inicializar: grow / assign escriben cada elemento vivo
+        alignas(default_alignment) T inline_[N];
+        std::vector<T, AlignedAllocator<T>> heap_;
+        size_t size_ = 0;
+
+        bool on_heap() const noexcept { return heap_.capacity() != 0; }
+
+        void take(SmallBuffer& other) {
+            if (other.on_heap()) {
+                heap_ = std::move(other.heap_);
+                size_ = other.size_;
+            } else {
+                assign(std::make_move_iterator(other.inline_),
+                       std::make_move_iterator(other.inline_ + other.size_));
+            }
+            other.size_ = 0;
+        }
+
+        void grow(size_t n, const T* value) {
+            if (on_heap() || n > N) {
+                if (!on_heap()) {
+                    heap_.reserve(n);
+                    heap_.assign(std::make_move_iterator(inline_), std::make_move_iterator(inline_ + size_));
+                }
+                if (value) heap_.resize(n, *value);
+                else heap_.resize(n);
+            } else if (n > size_) {
+                std::fill(inline_ + size_, inline_ + n, value ? *value : T{});
+            }
+            size_ = n;
+        }
+
+    public:
+        using value_type = T;
+        static constexpr size_t inline_capacity = N;
+
+        SmallBuffer() = default;
+
+        SmallBuffer(const SmallBuffer& other) { assign(other.begin(), other.end()); }
+
+        SmallBuffer(SmallBuffer&& other) noexcept(std::is_nothrow_move_assignable_v<T>) { take(other); }
+
+        SmallBuffer& operator=(const SmallBuffer& other) {
+            if (this != &other) assign(other.begin(), other.end());
+            return *this;
+        }
+
+        SmallBuffer& operator=(SmallBuffer&& other) noexcept(std::is_nothrow_move_assignable_v<T>) {
+            if (this != &other) take(other);
+            return *this;
+        }
+
+        size_t size() const noexcept { return size_; }
+        size_t capacity() const noexcept { return on_heap() ? heap_.capacity() : N; }
+        bool is_inline() const noexcept { return !on_heap(); }
+
+        T* data() noexcept { return on_heap() ? heap_.data() : inline_; }
+        const T* data() const noexcept { return on_heap() ? heap_.data() : inline_; }
+
+        T& operator[](size_t i) { return data()[i]; }
+        const T& operator[](size_t i) const { return data()[i]; }
+
+        T* begin() noexcept { return data(); }
+        T* end() noexcept { return data() + size_; }
+        const T* begin() const noexcept { return data(); }
+        const T* end() const noexcept { return data() + size_; }
+        const T* cbegin() const noexcept { return data(); }
+        const T* cend() const noexcept { return data() + size_; }
+
+        // Sin valor, los elementos nuevos se inicializan por valor (memset para tipos triviales)
+        void resize(size_t n) { grow(n, nullptr); }
+        void resize(size_t n, const T& value) { grow(n, &value); }
+
+        template <typename It>
+        void assign(It first, It last) {
+            const size_t n = static_cast<size_t>(std::distance(first, last));
+            if (on_heap() || n > N) heap_.assign(first, last);
+            else std::copy(first, last, inline_);
+            size_ = n;
+        }
+    };
+
+    // Políticas de almacenamiento para Tensor<T, Rank, Storage>
+    struct AlignedStorage {
+        template <typename T>
+        using container = std::vector<T, AlignedAllocator<T>>;
+    };
+
+    struct HugePageStorage {
+        template <typename T>
+        using container = std::vector<T, HugePageAllocator<T>>;
+    };
+
+    struct ExternalStorage {
+        template <typename T>
+        using container = ExternalBuffer<T>;
+    };
+
+    // Hasta InlineBytes de datos dentro del propio Tensor; más allá, como AlignedStorage.
+    // Solo para tensores pequeños y estables (bias, estados de Adam): el objeto crece en
+    // InlineBytes y, mientras los datos van en línea, moverlo cambia raw_data()
+    template <size_t InlineBytes = UTEC_TENSOR_INLINE_BYTES>
+    struct SmallStorage {
+        template <typename T>
+        using container = SmallBuffer<T, std::max<size_t>(1, InlineBytes / sizeof(T))>;
+    };
+
+}
+
+#endif //PROG3_TENSOR_FINAL_PROJECT_V2025_01_TENSOR_STORAGE_H
@@ -0,0 +1,266 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_TENSOR_VIEW_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_TENSOR_VIEW_H
+
+#include "tensor.h"
+#include "gemm.h"
+#include <type_traits>
+#include <concepts>
+#include <vector>
+
+namespace utec::algebra {
+
+    // Vista no propietaria sobre los datos de un Tensor: forma, strides y puntero.
+    // Opcionalmente indirecta el eje 0 con una tabla de indices (gather).
+    // La vista no extiende la vida del tensor ni de la tabla de indices.
+    template <typename T, size_t Rank>
+    class TensorView {
+        using value_type = std::remove_const_t<T>;
+
+        T* ptr_ = nullptr;
+        std::array<size_t, Rank> shapes_{};
+        std::array<size_t, Rank> strides_{};
+        const size_t* rows_ = nullptr;
+
+    public:
+        TensorView() = default;
+
+        TensorView(T* ptr,
+                   const std::array<size_t, Rank>& shape,
+                   const std::array<size_t, Rank>& strides,
+                   const size_t* rows = nullptr)
+            : ptr_(ptr), shapes_(shape), strides_(strides), rows_(rows) {}
+
+        template <typename Storage>
+        TensorView(Tensor<value_type, Rank, Storage>& tensor)
+            : ptr_(tensor.raw_data()), shapes_(tensor.shape()), strides_(contiguous_strides(tensor.shape())) {}
+
+        template <typename Storage>
+            requires std::is_const_v<T>
+        TensorView(const Tensor<value_type, Rank, Storage>& tensor)
+            : ptr_(tensor.raw_data()), shapes_(tensor.shape()), strides_(contiguous_strides(tensor.shape())) {}
+
+        template <typename U>
+            requires (std::is_const_v<T> && std::is_same_v<U, value_type>)
+        TensorView(const TensorView<U, Rank>& other)
+            : ptr_(other.data()), shapes_(other.shape()), strides_(other.strides()), rows_(other.row_indices()) {}
+
+        static std::array<size_t, Rank> contiguous_strides(const std::array<size_t, Rank>& shape) {
+            std::array<size_t, Rank> strides{};
+            size_t stride = 1;
+            for (size_t i = Rank; i-- > 0;) {
+                strides[i] = stride;
+                stride *= shape[i];
+            }
+            return strides;
+        }
+
+        const std::array<size_t, Rank>& shape() const noexcept { return shapes_; }
+        const std::array<size_t, Rank>& strides() const noexcept { return strides_; }
+        T* data() const noexcept { return ptr_; }
+        const size_t* row_indices() const noexcept { return rows_; }
+
+        size_t size() const {
+            size_t total = 1;
+            for (size_t dim : shapes_) total *= dim;
+            return total;
+        }
+
+        bool is_contiguous() const {
+            return rows_ == nullptr && strides_ == contiguous_strides(shapes_);
+        }
+
+        // Sigue la misma política que Tensor: comprobado salvo con NDEBUG
+        size_t offset(const std::array<size_t, Rank>& idxs) const {
+            if constexpr (bounds_checked) {
+                for (size_t i = 0; i < Rank; ++i)
+                    if (idxs[i] >= shapes_[i]) throw std::out_of_range("Index out of bounds");
+            } else {
+                for (size_t i = 0; i < Rank; ++i) UTEC_ASSUME(idxs[i] < shapes_[i]);
+            }
+            size_t flat = (rows_ ? rows_[idxs[0]] : idxs[0]) * strides_[0];
+            for (size_t i = 1; i < Rank; ++i)
+                flat += idxs[i] * strides_[i];
+            return flat;
+        }
+
+        template <typename... Idxs>
+        T& operator()(Idxs... idxs) const {
+            static_assert(sizeof...(Idxs) == Rank, "Número de índices incorrecto");
+            return ptr_[offset({static_cast<size_t>(idxs)...})];
+        }
+
+        // Sub-vista de las filas [begin, end) del eje 0, sin copia
+        TensorView rows(size_t begin, size_t end) const {
+            if (begin > end || end > shapes_[0]) {
+                throw std::out_of_range("Row range out of bounds");
+            }
+            TensorView result = *this;
+            result.shapes_[0] = end - begin;
+            if (rows_) result.rows_ = rows_ + begin;
+            else result.ptr_ = ptr_ + begin * strides_[0];
+            return result;
+        }
+
+        // Vista de las filas indicadas por `indices`, en ese orden, sin copia
+        TensorView gather(const size_t* indices, size_t count) const {
+            if (rows_) {
+                throw std::invalid_argument("Cannot gather from an already gathered view");
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (indices[i] >= shapes_[0]) throw std::out_of_range("Gather index out of bounds");
+            }
+            TensorView result = *this;
+            result.shapes_[0] = count;
+            result.rows_ = indices;
+            return result;
+        }
+    };
+
+    template <typename T, size_t Rank>
+    TensorView<const T, Rank> rows(const Tensor<T, Rank>& tensor, size_t begin, size_t end) {
+        return TensorView<const T, Rank>(tensor).rows(begin, end);
+    }
+
+    template <typename T, size_t Rank>
+    TensorView<T, Rank> rows(Tensor<T, Rank>& tensor, size_t begin, size_t end) {
+        return TensorView<T, Rank>(tensor).rows(begin, end);
+    }
+
+    template <typename T, size_t Rank>
+    TensorView<const T, Rank> gather(const Tensor<T, Rank>& tensor, const std::vector<size_t>& indices) {
+        return TensorView<const T, Rank>(tensor).gather(indices.data(), indices.size());
+    }
+
+    // Copia el contenido de la vista a un tensor contiguo
+    template <typename T, size_t Rank>
+    void materialize(TensorView<const T, Rank> src, Tensor<T, Rank>& dst) {
+        if (dst.shape() != src.shape()) {
+            dst.reshape(src.shape());
+        }
+        if (src.size() == 0) return;
+
+        T* out = dst.raw_data();
+        const size_t inner = src.shape()[Rank - 1];
+        const size_t inner_stride = src.strides()[Rank - 1];
+        std::array<size_t, Rank> idx{};
+        for (size_t done = 0; done < src.size(); done += inner) {
+            const T* in = src.data() + src.offset(idx);
+            if (inner_stride == 1) {
+                std::copy(in, in + inner, out);
+            } else {
+                for (size_t j = 0; j < inner; ++j) out[j] = in[j * inner_stride];
+            }
+            out += inner;
+            for (size_t d = Rank - 1; d-- > 0;) {
+                if (++idx[d] < src.shape()[d]) break;
+                idx[d] = 0;
+            }
+        }
+    }
+
+    template <typename T, size_t Rank>
+    Tensor<std::remove_const_t<T>, Rank> materialize(TensorView<T, Rank> src) {
+        Tensor<std::remove_const_t<T>, Rank> dst(src.shape());
+        materialize(TensorView<const std::remove_const_t<T>, Rank>(src), dst);
+        return dst;
+    }
+
+    // Operandos aceptados por los productos matriciales: Tensor<T,2> o TensorView<T,2>
+    template <typename X>
+    struct matrix_operand : std::false_type {};
+
+    template <typename T, typename Storage>
+    struct matrix_operand<Tensor<T, 2, Storage>> : std::true_type { using value_type = T; };
+
+    template <typename T>
+    struct matrix_operand<TensorView<T, 2>> : std::true_type { using value_type = std::remove_const_t<T>; };
+
+    template <typename X>
+    concept MatrixOperand = matrix_operand<std::remove_cvref_t<X>>::value;
+
+    template <typename X>
+    using operand_value_t = typename matrix_operand<std::remove_cvref_t<X>>::value_type;
+
+    namespace detail {
+
+        template <typename T>
+        StridedMatrix<T> as_strided(TensorView<const T, 2> v, bool transposed = false) {
+            if (transposed) return {v.data(), v.strides()[1], v.strides()[0], nullptr, v.row_indices()};
+            return {v.data(), v.strides()[0], v.strides()[1], v.row_indices(), nullptr};
+        }
+
+    }
+
+    // Variantes *_into: escriben en `out`, reutilizando su memoria si ya tiene capacidad.
+    // El epílogo opcional ep(i, j, fila, cols) recibe cada tramo de fila de out ya calculado,
+    // en accumulator_t<T> y mientras sigue en caché (p. ej. para sumar el bias y activar).
+    template <MatrixOperand A, MatrixOperand B, typename Epilogue = detail::NoEpilogue>
+        requires std::same_as<operand_value_t<A>, operand_value_t<B>>
+    void matrix_product_into(const A& a, const B& b, Tensor<operand_value_t<A>, 2>& out,
+                             const Epilogue& ep = {}) {
+        using T = operand_value_t<A>;
+        TensorView<const T, 2> va(a), vb(b);
+        if (va.shape()[1] != vb.shape()[0]) {
+            throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        }
+        out.reshape({va.shape()[0], vb.shape()[1]});
+        detail::gemm_strided(va.shape()[0], vb.shape()[1], va.shape()[1],
+                             detail::as_strided(va), detail::as_strided(vb),
+                             out.raw_data(), vb.shape()[1], false, ep);
+    }
+
+    template <MatrixOperand A, MatrixOperand B>
+        requires std::same_as<operand_value_t<A>, operand_value_t<B>>
+    void matrix_product_tn_into(const A& a, const B& b, Tensor<operand_value_t<A>, 2>& out) {
+        using T = operand_value_t<A>;
+        TensorView<const T, 2> va(a), vb(b);
+        if (va.shape()[0] != vb.shape()[0]) {
+            throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        }
+        out.reshape({va.shape()[1], vb.shape()[1]});
+        detail::gemm_strided(va.shape()[1], vb.shape()[1], va.shape()[0],
+                             detail::as_strided(va, true), detail::as_strided(vb),
+                             out.raw_data(), vb.shape()[1], false);
+    }
+
+    template <MatrixOperand A, MatrixOperand B>
+        requires std::same_as<operand_value_t<A>, operand_value_t<B>>
+    void matrix_product_nt_into(const A& a, const B& b, Tensor<operand_value_t<A>, 2>& out) {
+        using T = operand_value_t<A>;
+        TensorView<const T, 2> va(a), vb(b);
+        if (va.shape()[1] != vb.shape()[1]) {
+            throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        }
+        out.reshape({va.shape()[0], vb.shape()[0]});
+        detail::gemm_strided(va.shape()[0], vb.shape()[0], va.shape()[1],
+                             detail::as_strided(va), detail::as_strided(vb, true),
+                             out.raw_data(), vb.shape()[0], false);
+    }
+
+    template <MatrixOperand A, MatrixOperand B>
+        requires std::same_as<operand_value_t<A>, operand_value_t<B>>
+    Tensor<operand_value_t<A>, 2> matrix_product(const A& a, const B& b) {
+        Tensor<operand_value_t<A>, 2> result(0, 0);
+        matrix_product_into(a, b, result);
+        return result;
+    }
+
+    template <MatrixOperand A, MatrixOperand B>
+        requires std::same_as<operand_value_t<A>, operand_value_t<B>>
+    Tensor<operand_value_t<A>, 2> matrix_product_tn(const A& a, const B& b) {
+        Tensor<operand_value_t<A>, 2> result(0, 0);
+        matrix_product_tn_into(a, b, result);
+        return result;
+    }
+
+    template <MatrixOperand A, MatrixOperand B>
+        requires std::same_as<operand_value_t<A>, operand_value_t<B>>
+    Tensor<operand_value_t<A>, 2> matrix_product_nt(const A& a, const B& b) {
+        Tensor<operand_value_t<A>, 2> result(0, 0);
+        matrix_product_nt_into(a, b, result);
+        return result;
+    }
+
+}
+
+#endif //PROG3_TENSOR_FINAL_PROJECT_V2025_01_TENSOR_VIEW_H
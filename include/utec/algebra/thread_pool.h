@@ -0,0 +1,186 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_THREAD_POOL_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace utec::algebra {
+
+    // Pool de hilos persistente: los hilos se crean una vez y esperan trabajo,
+    // así cada parallel_for solo paga una notificación y no la creación de hilos.
+    // El hilo que llama también ejecuta tareas.
+    class ThreadPool {
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        std::mutex submit_;
+
+        // Trabajo en curso; fn_ recibe el contexto y el índice de la tarea
+        void (*fn_)(void*, size_t) = nullptr;
+        void* ctx_ = nullptr;
+        size_t count_ = 0;
+        std::atomic<size_t> next_{0};
+        size_t pending_ = 0;
+        uint64_t generation_ = 0;
+        bool stop_ = false;
+        std::exception_ptr error_;
+
+        static inline thread_local bool inside_ = false;
+
+        void run_tasks() {
+            try {
+                for (size_t i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1))
+                    fn_(ctx_, i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+                // Las tareas restantes se descartan
+                next_.store(count_);
+            }
+        }
+
+        void worker_loop() {
+            inside_ = true;
+            uint64_t seen = 0;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                    if (stop_) return;
+                    seen = generation_;
+                }
+                run_tasks();
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_ == 0) done_.notify_one();
+            }
+        }
+
+    public:
+        // threads cuenta también al hilo que llama: threads - 1 hilos de trabajo
+        explicit ThreadPool(size_t threads) {
+            for (size_t i = 1; i < threads; ++i)
+                workers_.emplace_back([this] { worker_loop(); });
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto& worker : workers_) worker.join();
+        }
+
+        size_t size() const noexcept { return workers_.size() + 1; }
+
+        // true dentro de una tarea de algún pool: ahí un parallel_for corre en serie
+        static bool on_worker_thread() noexcept { return inside_; }
+
+        // Ejecuta f(i) para i en [0, count) y espera a que terminen todas.
+        // Llamadas anidadas (desde una tarea) o concurrentes se ejecutan en serie.
+        // La primera excepción lanzada por una tarea se relanza aquí.
+        template <typename F>
+        void parallel_for(size_t count, F&& f) {
+            if (count == 0) return;
+            std::unique_lock<std::mutex> submit(submit_, std::defer_lock);
+            if (count == 1 || workers_.empty() || inside_ || !submit.try_lock()) {
+                for (size_t i = 0; i < count; ++i) f(i);
+                return;
+            }
+
+            using Fn = std::remove_reference_t<F>;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                fn_ = [](void* ctx, size_t i) { (*static_cast<Fn*>(ctx))(i); };
+                ctx_ = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+                count_ = count;
+                next_.store(0);
+                pending_ = workers_.size();
+                error_ = nullptr;
+                ++generation_;
+            }
+            wake_.notify_all();
+
+            inside_ = true;
+            run_tasks();
+            inside_ = false;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [&] { return pending_ == 0; });
+            if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    };
+
+    namespace detail {
+
+        // UTEC_NUM_THREADS si está definida y es válida; si no, los núcleos disponibles
+        inline size_t default_num_threads() {
+            if (const char* env = std::getenv("UTEC_NUM_THREADS")) {
+                char* end = nullptr;
+                const long value = std::strtol(env, &end, 10);
+                if (end != env && value > 0) return static_cast<size_t>(value);
+            }
+            const unsigned hw = std::thread::hardware_concurrency();
+            return hw > 0 ? hw : 1;
+        }
+
+        inline std::mutex& pool_mutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        inline std::unique_ptr<ThreadPool>& pool_slot() {
+            static std::unique_ptr<ThreadPool> pool;
+            return pool;
+        }
+
+        // Copia del puntero de pool_slot() para leerlo sin tomar pool_mutex()
+        inline std::atomic<ThreadPool*>& pool_pointer() {
+            static std::atomic<ThreadPool*> pointer{nullptr};
+            return pointer;
+        }
+
+    }
+
+    // Pool global compartido por GEMM y el resto de la biblioteca. Tras crearlo, cada
+    // llamada es una sola lectura atómica; el mutex solo se toma para crearlo
+    inline ThreadPool& thread_pool() {
+        if (ThreadPool* pool = detail::pool_pointer().load(std::memory_order_acquire)) return *pool;
+        std::lock_guard<std::mutex> lock(detail::pool_mutex());
+        auto& pool = detail::pool_slot();
+        if (!pool) {
+            pool = std::make_unique<ThreadPool>(detail::default_num_threads());
+            detail::pool_pointer().store(pool.get(), std::memory_order_release);
+        }
+        return *pool;
+    }
+
+    // Cambia el número de hilos del pool global (0 = valor por defecto).
+    // No debe llamarse mientras otro hilo use el pool.
+    inline void set_num_threads(size_t threads) {
+        std::lock_guard<std::mutex> lock(detail::pool_mutex());
+        auto fresh = std::make_unique<ThreadPool>(threads > 0 ? threads : detail::default_num_threads());
+        detail::pool_pointer().store(fresh.get(), std::memory_order_release);
+        detail::pool_slot() = std::move(fresh);
+    }
+
+    inline size_t num_threads() {
+        return thread_pool().size();
+    }
+
+}
+
+#endif //PROG3_TENSOR_FINAL_PROJECT_V2025_01_THREAD_POOL_H
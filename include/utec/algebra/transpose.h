@@ -0,0 +1,165 @@
+#ifndef PROG3_TENSOR_FINAL_PROJECT_V2025_01_TRANSPOSE_H
+#define PROG3_TENSOR_FINAL_PROJECT_V2025_01_TRANSPOSE_H
+
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include "gemm.h"
+
+// Transpuesta por bloques: se recorre la matriz en teselas que caben en L1 para
+// que tanto la lectura por filas como la escritura por columnas queden en caché.
+// Dentro de cada tesela, los bloques 8x8 de float se transponen en registros AVX.
+namespace utec::algebra {
+
+    namespace detail {
+
+        inline constexpr size_t transpose_tile = 32;
+
+        template<typename T>
+        void transpose_scalar(size_t rows, size_t cols, const T* src, size_t lds, T* dst, size_t ldd) {
+            for (size_t i = 0; i < rows; ++i)
+                for (size_t j = 0; j < cols; ++j)
+                    dst[j * ldd + i] = src[i * lds + j];
+        }
+
+#ifdef UTEC_GEMM_X86
+        __attribute__((target("avx")))
+        inline void transpose_8x8_registers(__m256 (&r)[8]) {
+            const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+            const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+            const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+            const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+            const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+            const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+            const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+            const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+            const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+            r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+            r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+            r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+            r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+            r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+            r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+            r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+            r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+        }
+
+        // dst (8x8) = src^T; se lee todo antes de escribir, así que src == dst es válido
+        __attribute__((target("avx")))
+        inline void transpose_8x8_avx(const float* src, size_t lds, float* dst, size_t ldd) {
+            __m256 r[8];
+            for (int i = 0; i < 8; ++i) r[i] = _mm256_loadu_ps(src + i * lds);
+            transpose_8x8_registers(r);
+            for (int i = 0; i < 8; ++i) _mm256_storeu_ps(dst + i * ldd, r[i]);
+        }
+
+        // Intercambia los bloques 8x8 a y b transponiendo ambos (a = b^T, b = a^T)
+        __attribute__((target("avx")))
+        inline void transpose_swap_8x8_avx(float* a, float* b, size_t ld) {
+            __m256 ra[8], rb[8];
+            for (int i = 0; i < 8; ++i) {
+                ra[i] = _mm256_loadu_ps(a + i * ld);
+                rb[i] = _mm256_loadu_ps(b + i * ld);
+            }
+            transpose_8x8_registers(ra);
+            transpose_8x8_registers(rb);
+            for (int i = 0; i < 8; ++i) {
+                _mm256_storeu_ps(a + i * ld, rb[i]);
+                _mm256_storeu_ps(b + i * ld, ra[i]);
+            }
+        }
+#endif
+
+        // Los kernels AVX siguen al ISA activo de GEMM (set_gemm_isa(Scalar) los desactiva)
+        template<typename T>
+        bool use_transpose_avx() {
+#ifdef UTEC_GEMM_X86
+            return std::is_same_v<T, float> && gemm_isa() != GemmIsa::Scalar;
+#else
+            return false;
+#endif
+        }
+
+        template<typename T>
+        void transpose_block(size_t rows, size_t cols, const T* src, size_t lds, T* dst, size_t ldd, bool avx) {
+#ifdef UTEC_GEMM_X86
+            if constexpr (std::is_same_v<T, float>) {
+                if (avx) {
+                    const size_t rows8 = rows / 8 * 8, cols8 = cols / 8 * 8;
+                    for (size_t i = 0; i < rows8; i += 8)
+                        for (size_t j = 0; j < cols8; j += 8)
+                            transpose_8x8_avx(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+                    transpose_scalar(rows8, cols - cols8, src + cols8, lds, dst + cols8 * ldd, ldd);
+                    transpose_scalar(rows - rows8, cols, src + rows8 * lds, lds, dst + rows8, ldd);
+                    return;
+                }
+            }
+#endif
+            (void)avx;
+            transpose_scalar(rows, cols, src, lds, dst, ldd);
+        }
+
+    }
+
+    // dst (cols x rows) = src (rows x cols)^T; lds/ldd son los pasos entre filas.
+    // src y dst no deben solaparse.
+    template<typename T>
+    void transpose(size_t rows, size_t cols, const T* src, size_t lds, T* dst, size_t ldd) {
+        const bool avx = detail::use_transpose_avx<T>();
+        constexpr size_t tile = detail::transpose_tile;
+        for (size_t i = 0; i < rows; i += tile)
+            for (size_t j = 0; j < cols; j += tile)
+                detail::transpose_block(std::min(tile, rows - i), std::min(tile, cols - j),
+                                        src + i * lds + j, lds, dst + j * ldd + i, ldd, avx);
+    }
+
+    // Transpuesta en sitio de una matriz cuadrada n x n: cada par de teselas
+    // (i, j) y (j, i) se intercambia transponiéndolas, sin buffer auxiliar.
+    template<typename T>
+    void transpose_inplace(size_t n, T* a, size_t lda) {
+        constexpr size_t tile = detail::transpose_tile;
+#ifdef UTEC_GEMM_X86
+        if constexpr (std::is_same_v<T, float>) {
+            if (detail::use_transpose_avx<T>()) {
+                const size_t n8 = n / 8 * 8;
+                for (size_t ib = 0; ib < n8; ib += tile) {
+                    const size_t ie = std::min(ib + tile, n8);
+                    for (size_t jb = ib; jb < n8; jb += tile) {
+                        const size_t je = std::min(jb + tile, n8);
+                        for (size_t i = ib; i < ie; i += 8)
+                            for (size_t j = std::max(jb, i); j < je; j += 8) {
+                                if (i == j) detail::transpose_8x8_avx(a + i * lda + i, lda, a + i * lda + i, lda);
+                                else detail::transpose_swap_8x8_avx(a + i * lda + j, a + j * lda + i, lda);
+                            }
+                    }
+                }
+                // Últimas n - n8 columnas (menos de 8)
+                for (size_t j = n8; j < n; ++j)
+                    for (size_t i = 0; i < j; ++i)
+                        std::swap(a[i * lda + j], a[j * lda + i]);
+                return;
+            }
+        }
+#endif
+        for (size_t ib = 0; ib < n; ib += tile) {
+            const size_t ie = std::min(ib + tile, n);
+            for (size_t jb = ib; jb < n; jb += tile) {
+                const size_t je = std::min(jb + tile, n);
+                for (size_t i = ib; i < ie; ++i)
+                    for (size_t j = std::max(jb, i + 1); j < je; ++j)
+                        std::swap(a[i * lda + j], a[j * lda + i]);
+            }
+        }
+    }
+
+}
+
+#endif //PROG3_TENSOR_FINAL_PROJECT_V2025_01_TRANSPOSE_H
@@ -0,0 +1,201 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_BATCH_PREFETCHER_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_BATCH_PREFETCHER_H
+
+#include "algebra/tensor.h"
+#include "algebra/tensor_view.h"
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace utec::neural_network {
+
+    // Cola acotada sin bloqueos para un productor y un consumidor. tail_ solo lo escribe el
+    // productor y head_ el consumidor, cada uno en su línea de caché. push / pop esperan con
+    // atomic::wait cuando la cola está llena / vacía en vez de girar
+    template<typename T, size_t Capacity>
+    class SpscRing {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity debe ser potencia de 2");
+
+        std::array<T, Capacity> items_{};
+        alignas(utec::algebra::default_alignment) std::atomic<size_t> head_{0};
+        alignas(utec::algebra::default_alignment) std::atomic<size_t> tail_{0};
+
+    public:
+        static constexpr size_t capacity() noexcept { return Capacity; }
+
+        bool try_push(const T& item) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == Capacity) return false;
+            items_[tail & (Capacity - 1)] = item;
+            tail_.store(tail + 1, std::memory_order_release);
+            tail_.notify_one();
+            return true;
+        }
+
+        bool try_pop(T& item) {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) return false;
+            item = items_[head & (Capacity - 1)];
+            head_.store(head + 1, std::memory_order_release);
+            head_.notify_one();
+            return true;
+        }
+
+        void push(const T& item) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            for (size_t head; tail - (head = head_.load(std::memory_order_acquire)) == Capacity;)
+                head_.wait(head, std::memory_order_acquire);
+            try_push(item);
+        }
+
+        T pop() {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            for (size_t tail; (tail = tail_.load(std::memory_order_acquire)) == head;)
+                tail_.wait(tail, std::memory_order_acquire);
+            T item{};
+            try_pop(item);
+            return item;
+        }
+    };
+
+    template<typename T>
+    struct BatchPrefetchOptions {
+        size_t buffers = 3;        // 2 = doble buffer, 3 = triple
+        bool shuffle = false;      // permuta las filas en cada época
+        uint32_t seed = 42;
+        // Se aplica a cada lote en el hilo productor (normalización, aumentos de datos...)
+        std::function<void(utec::algebra::Tensor<T,2>&, utec::algebra::Tensor<T,2>&)> transform;
+    };
+
+    // Prepara los lotes de epochs épocas en un hilo aparte mientras se entrena el anterior.
+    // Cada lote se copia (en el orden de la época) a uno de buffers buffers propios; los
+    // índices de buffer pasan al consumidor por una SpscRing y vuelven por otra al liberarlos.
+    // X e Y deben vivir mientras exista el prefetcher.
+    template<typename T>
+    class BatchPrefetcher {
+        static constexpr size_t max_buffers = 3;
+        // Marca de fin (o de error) en las colas; cabe siempre: capacidad 4 > max_buffers
+        static constexpr size_t sentinel = std::numeric_limits<size_t>::max();
+
+        struct Slot {
+            utec::algebra::Tensor<T,2> X{0, 0}, Y{0, 0};
+        };
+
+        const utec::algebra::Tensor<T,2>& X_;
+        const utec::algebra::Tensor<T,2>& Y_;
+        size_t batch_size_, epochs_;
+        BatchPrefetchOptions<T> options_;
+        std::vector<Slot> slots_;
+        SpscRing<size_t, 4> ready_, free_;
+        std::atomic<bool> stop_{false};
+        std::exception_ptr error_;
+        bool finished_ = false;
+        std::thread producer_;
+
+        void gather(Slot& slot, const std::vector<size_t>& order, size_t begin, size_t end) {
+            const size_t x_cols = X_.shape()[1], y_cols = Y_.shape()[1];
+            slot.X.reshape({end - begin, x_cols});
+            slot.Y.reshape({end - begin, y_cols});
+            const T* x = X_.raw_data();
+            const T* y = Y_.raw_data();
+            if (!options_.shuffle) {
+                std::copy(x + begin * x_cols, x + end * x_cols, slot.X.raw_data());
+                std::copy(y + begin * y_cols, y + end * y_cols, slot.Y.raw_data());
+                return;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                const size_t r = order[i];
+                std::copy(x + r * x_cols, x + (r + 1) * x_cols, slot.X.raw_data() + (i - begin) * x_cols);
+                std::copy(y + r * y_cols, y + (r + 1) * y_cols, slot.Y.raw_data() + (i - begin) * y_cols);
+            }
+        }
+
+        void produce() {
+            try {
+                const size_t num_samples = X_.shape()[0];
+                std::vector<size_t> order(options_.shuffle ? num_samples : 0);
+                std::iota(order.begin(), order.end(), size_t(0));
+                std::mt19937 gen(options_.seed);
+
+                for (size_t epoch = 0; epoch < epochs_; ++epoch) {
+                    if (options_.shuffle) std::shuffle(order.begin(), order.end(), gen);
+                    for (size_t begin = 0; begin < num_samples; begin += batch_size_) {
+                        const size_t slot = free_.pop();
+                        if (slot == sentinel || stop_.load(std::memory_order_acquire)) return;
+                        Slot& s = slots_[slot];
+                        gather(s, order, begin, std::min(begin + batch_size_, num_samples));
+                        if (options_.transform) options_.transform(s.X, s.Y);
+                        ready_.push(slot);
+                    }
+                }
+            } catch (...) {
+                error_ = std::current_exception();
+            }
+            ready_.push(sentinel);
+        }
+
+    public:
+        // Un lote listo: vistas a un buffer que no cambia hasta release(batch)
+        struct Batch {
+            utec::algebra::TensorView<const T,2> X, Y;
+            size_t slot;
+        };
+
+        BatchPrefetcher(const utec::algebra::Tensor<T,2>& X, const utec::algebra::Tensor<T,2>& Y,
+                        size_t batch_size, size_t epochs, BatchPrefetchOptions<T> options = {})
+          : X_{X}, Y_{Y}, batch_size_{batch_size}, epochs_{epochs}, options_{std::move(options)}
+        {
+            if (X.shape()[0] != Y.shape()[0]) {
+                throw std::invalid_argument("X and Y must have the same number of samples");
+            }
+            if (batch_size == 0) {
+                throw std::invalid_argument("Batch size must be positive");
+            }
+            options_.buffers = std::clamp<size_t>(options_.buffers, 2, max_buffers);
+            slots_.resize(options_.buffers);
+            for (size_t i = 0; i < slots_.size(); ++i) free_.push(i);
+            producer_ = std::thread([this] { produce(); });
+        }
+
+        BatchPrefetcher(const BatchPrefetcher&) = delete;
+        BatchPrefetcher& operator=(const BatchPrefetcher&) = delete;
+
+        // Despierta al productor si espera un buffer libre y lo espera
+        ~BatchPrefetcher() {
+            stop_.store(true, std::memory_order_release);
+            free_.try_push(sentinel);
+            producer_.join();
+        }
+
+        size_t buffers() const noexcept { return slots_.size(); }
+
+        // Siguiente lote en orden; espera si aún no está listo. Relanza los errores del
+        // productor (p. ej. de transform) y lanza std::out_of_range si ya no quedan lotes
+        Batch next() {
+            const size_t slot = finished_ ? sentinel : ready_.pop();
+            if (slot == sentinel) {
+                finished_ = true;
+                if (error_) std::rethrow_exception(error_);
+                throw std::out_of_range("No more batches to prefetch");
+            }
+            return Batch{slots_[slot].X, slots_[slot].Y, slot};
+        }
+
+        // Devuelve el buffer al productor; las vistas del lote dejan de ser válidas
+        void release(const Batch& batch) {
+            free_.push(batch.slot);
+        }
+    };
+
+}
+
+#endif // PROG3_NN_FINAL_PROJECT_V2025_01_BATCH_PREFETCHER_H
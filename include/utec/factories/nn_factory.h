@@ -10,6 +10,7 @@
 #include <string>
 #include <stdexcept>
 #include <random>
+#include <type_traits>
 
 namespace utec::neural_network {
 
@@ -30,7 +31,9 @@ namespace utec::neural_network {
                     T fan_in = static_cast<T>(w.shape()[0]);
                     T fan_out = static_cast<T>(w.shape()[1]);
                     T limit = std::sqrt(T(6.0) / (fan_in + fan_out));
-                    std::uniform_real_distribution<T> dist(-limit, limit);
+                    // bf16 / fp16 se muestrean en float y se redondean al guardarse
+                    using sample_t = std::conditional_t<std::is_floating_point_v<T>, T, float>;
+                    std::uniform_real_distribution<sample_t> dist(-limit, limit);
 
                     for (size_t i = 0; i < w.size(); ++i) {
                         w[i] = dist(gen);
@@ -73,6 +76,29 @@ namespace utec::neural_network {
         static std::unique_ptr<ILayer<T>> create_sigmoid() {
             return std::make_unique<Sigmoid<T>>();
         }
+
+        // Dense + activación ("relu" o "sigmoid") en una sola capa
+        static std::unique_ptr<ILayer<T>> create_fused_dense(size_t input_size, size_t output_size,
+                                                            const std::string& activation) {
+            auto dense = create_dense(input_size, output_size);
+            auto fused = fuse(*dense, *create_layer(activation));
+            if (!fused) {
+                throw std::invalid_argument("Dense can only be fused with relu or sigmoid: " + activation);
+            }
+            return fused;
+        }
+
+        // FusedDense con los pesos de `layer` si es una Dense<T> seguida de ReLU o Sigmoid;
+        // nullptr si el par no se puede fusionar
+        static std::unique_ptr<ILayer<T>> fuse(const ILayer<T>& layer, const ILayer<T>& activation) {
+            const auto* dense = dynamic_cast<const Dense<T>*>(&layer);
+            if (!dense) return nullptr;
+            if (dynamic_cast<const ReLU<T>*>(&activation))
+                return std::make_unique<FusedDense<T, ReLU>>(*dense);
+            if (dynamic_cast<const Sigmoid<T>*>(&activation))
+                return std::make_unique<FusedDense<T, Sigmoid>>(*dense);
+            return nullptr;
+        }
     };
 
     template<typename T>
@@ -107,8 +133,8 @@ namespace utec::neural_network {
     class LossFactory {
     public:
         static std::unique_ptr<ILoss<T,2>> create_loss(const std::string& type,
-                                                      const Tensor<T,2>& y_pred,
-                                                      const Tensor<T,2>& y_true) {
+                                                      TensorView<const T,2> y_pred,
+                                                      TensorView<const T,2> y_true) {
             if (type == "mse") {
                 return std::make_unique<MSELoss<T>>(y_pred, y_true);
             }
@@ -120,13 +146,13 @@ namespace utec::neural_network {
             }
         }
 
-        static std::unique_ptr<ILoss<T,2>> create_mse(const Tensor<T,2>& y_pred,
-                                                     const Tensor<T,2>& y_true) {
+        static std::unique_ptr<ILoss<T,2>> create_mse(TensorView<const T,2> y_pred,
+                                                     TensorView<const T,2> y_true) {
             return std::make_unique<MSELoss<T>>(y_pred, y_true);
         }
 
-        static std::unique_ptr<ILoss<T,2>> create_bce(const Tensor<T,2>& y_pred,
-                                                     const Tensor<T,2>& y_true) {
+        static std::unique_ptr<ILoss<T,2>> create_bce(TensorView<const T,2> y_pred,
+                                                     TensorView<const T,2> y_true) {
             return std::make_unique<BCELoss<T>>(y_pred, y_true);
         }
     };
@@ -146,8 +172,8 @@ namespace utec::neural_network {
         }
         
         static std::unique_ptr<ILoss<T,2>> create_loss(const std::string& type,
-                                                      const Tensor<T,2>& y_pred,
-                                                      const Tensor<T,2>& y_true) {
+                                                      TensorView<const T,2> y_pred,
+                                                      TensorView<const T,2> y_true) {
             return LossFactory<T>::create_loss(type, y_pred, y_true);
         }
     };
@@ -4,6 +4,7 @@
 #include "neural_network/nn_interfaces.h"
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 namespace utec::algebra {
 
@@ -20,55 +21,85 @@ namespace utec::algebra {
 
 namespace utec::neural_network {
 
+    // Margen para alejar las probabilidades de 0 y 1; en 16 bits 1 - 1e-8 se redondea a 1
+    template<typename T>
+    T probability_epsilon() {
+        if constexpr (utec::algebra::is_half_v<T>) return std::numeric_limits<T>::epsilon();
+        else return T(1e-8);
+    }
+
+    // Las perdidas guardan vistas, no copias: y_pred / y_true deben vivir mientras se use el objeto
     template<typename T>
     struct MSELoss final : ILoss<T,2> {
-        Tensor<T,2> y_pred_, y_true_;
-        MSELoss(const Tensor<T,2>& yp, const Tensor<T,2>& yt)
+        TensorView<const T,2> y_pred_, y_true_;
+        MSELoss(TensorView<const T,2> yp, TensorView<const T,2> yt)
           : y_pred_{yp}, y_true_{yt} {}
 
         T loss() const override {
             T sum = T(0);
-            auto n = utec::algebra::calculateTotalSize(y_pred_);
-            for (size_t i = 0; i < n; ++i) {
-                T d = y_pred_[i] - y_true_[i];
-                sum += d*d;
-            }
-            return sum / static_cast<T>(n);
+            auto s = y_pred_.shape();
+            for (size_t i = 0; i < s[0]; ++i)
+                for (size_t j = 0; j < s[1]; ++j) {
+                    T d = y_pred_(i,j) - y_true_(i,j);
+                    sum += d*d;
+                }
+            return sum / static_cast<T>(y_pred_.size());
         }
 
         Tensor<T,2> loss_gradient() const override {
-            auto grad = Tensor<T,2>(y_pred_.shape());
-            T inv = T(2) / static_cast<T>(utec::algebra::calculateTotalSize(y_pred_));
-            for (size_t i = 0; i < utec::algebra::calculateTotalSize(grad); ++i)
-                grad[i] = inv * (y_pred_[i] - y_true_[i]);
+            auto grad = Tensor<T,2>(0, 0);
+            loss_gradient_into(grad);
             return grad;
         }
+
+        void loss_gradient_into(Tensor<T,2>& grad) const override {
+            auto s = y_pred_.shape();
+            grad.reshape(s);
+            T inv = T(2) / static_cast<T>(y_pred_.size());
+            for (size_t i = 0; i < s[0]; ++i)
+                for (size_t j = 0; j < s[1]; ++j)
+                    grad(i,j) = inv * (y_pred_(i,j) - y_true_(i,j));
+        }
     };
 
     template<typename T>
     struct BCELoss final : ILoss<T,2> {
-        Tensor<T,2> y_pred_, y_true_;
-        BCELoss(const Tensor<T,2>& yp, const Tensor<T,2>& yt)
+        TensorView<const T,2> y_pred_, y_true_;
+        BCELoss(TensorView<const T,2> yp, TensorView<const T,2> yt)
           : y_pred_{yp}, y_true_{yt} {}
 
         T loss() const override {
+            const T eps = probability_epsilon<T>();
             T sum = T(0);
-            auto n = utec::algebra::calculateTotalSize(y_pred_);
-            for (size_t i = 0; i < n; ++i) {
-                T p = std::min(std::max(y_pred_[i], T(1e-8)), T(1)-T(1e-8));
-                T t = y_true_[i];
-                sum -= t*std::log(p) + (T(1)-t)*std::log(T(1)-p);
-            }
-            return sum / static_cast<T>(n);
+            auto s = y_pred_.shape();
+            for (size_t i = 0; i < s[0]; ++i)
+                for (size_t j = 0; j < s[1]; ++j) {
+                    T p = std::clamp(y_pred_(i,j), eps, T(1 - eps));
+                    T t = y_true_(i,j);
+                    sum -= t*std::log(p) + (T(1)-t)*std::log(T(1)-p);
+                }
+            return sum / static_cast<T>(y_pred_.size());
         }
 
         Tensor<T,2> loss_gradient() const override {
-            auto grad = Tensor<T,2>(y_pred_.shape());
-            T inv = T(1) / static_cast<T>(utec::algebra::calculateTotalSize(y_pred_));
-            for (size_t i = 0; i < utec::algebra::calculateTotalSize(grad); ++i)
-                grad[i] = inv * ((y_pred_[i] - y_true_[i]) / (y_pred_[i]*(T(1)-y_pred_[i])));
+            auto grad = Tensor<T,2>(0, 0);
+            loss_gradient_into(grad);
             return grad;
         }
+
+        void loss_gradient_into(Tensor<T,2>& grad) const override {
+            auto s = y_pred_.shape();
+            grad.reshape(s);
+            const T eps = probability_epsilon<T>();
+            T inv = T(1) / static_cast<T>(y_pred_.size());
+            for (size_t i = 0; i < s[0]; ++i)
+                for (size_t j = 0; j < s[1]; ++j) {
+                    T p = y_pred_(i,j);
+                    // Una sigmoide de 16 bits satura en 0 o 1 exactos: sin el margen, 0 / 0
+                    if constexpr (utec::algebra::is_half_v<T>) p = std::clamp(p, eps, T(1 - eps));
+                    grad(i,j) = inv * ((p - y_true_(i,j)) / (p*(T(1)-p)));
+                }
+        }
     };
 
 }
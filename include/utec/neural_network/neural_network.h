@@ -3,60 +3,325 @@
 
 #include "nn_interfaces.h"
 #include "activations/nn_activation.h"
+#include "factories/nn_factory.h"
 #include "optimizers/nn_optimizer.h"
+#include "data_processing/batch_prefetcher.h"
 #include "algebra/tensor.h"
+#include "algebra/reductions.h"
+#include "algebra/thread_pool.h"
+#include <atomic>
 #include <memory>
 #include <vector>
+#include <algorithm>
+#include <utility>
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
 
 namespace utec::neural_network {
 
+    // Temporales de un paso de entrenamiento. Viven con la red y solo crecen: tras el
+    // primer lote, los pasos siguientes (y las llamadas posteriores a train) reutilizan
+    // la misma memoria, también en el último lote más corto.
+    template<typename T>
+    struct TrainingWorkspace {
+        utec::algebra::Tensor<T,2> out{0, 0}, next{0, 0};
+        utec::algebra::Tensor<T,2> grad{0, 0}, grad_next{0, 0};
+        utec::algebra::Tensor<size_t,2> predicted{0, 0}, expected{0, 0};
+    };
+
     template<typename T>
     class NeuralNetwork {
-        std::vector<std::unique_ptr<ILayer<T>>> layers_;
+        using Layers = std::vector<std::unique_ptr<ILayer<T>>>;
+
+        // Réplica del entrenamiento en paralelo de datos: capas y temporales propios (la
+        // réplica 0 usa los de la red) y una copia de sus gradientes para la reducción
+        struct Replica {
+            Layers layers;
+            TrainingWorkspace<T> workspace;
+            ParameterViews<T> views;
+            std::vector<utec::algebra::Tensor<T,2>> grads;
+            T loss = T(0);
+            size_t correct = 0;
+            bool ok = true;
+        };
+
+        Layers layers_;
+        std::optional<LossScaler> loss_scaler_;
+        std::optional<BatchPrefetchOptions<T>> prefetch_;
+        TrainingWorkspace<T> workspace_;
+        size_t data_parallel_ = 1;
+        std::vector<Replica> replicas_;
+        std::vector<Replica> async_replicas_;
+
+        Layers& layers_of(size_t r) { return r == 0 ? layers_ : replicas_[r].layers; }
+        TrainingWorkspace<T>& workspace_of(size_t r) { return r == 0 ? workspace_ : replicas_[r].workspace; }
+
+        // Forward, pérdida y backward de un lote. El gradiente de la pérdida se multiplica por
+        // factor (escala de la pérdida por la fracción del lote); false si las formas no encajan
+        template<template<typename...> class LossType>
+        static bool backpropagate(Layers& layers, TrainingWorkspace<T>& ws,
+                                  utec::algebra::TensorView<const T,2> X_batch,
+                                  utec::algebra::TensorView<const T,2> Y_batch,
+                                  float factor, T& loss, size_t& correct) {
+            auto& [out, next, grad, grad_next, predicted, expected] = ws;
+
+            layers[0]->forward_into(X_batch, out);
+            for (size_t i = 1; i < layers.size(); ++i) {
+                layers[i]->forward_into(out, next);
+                std::swap(out, next);
+            }
 
-    public:
-        void add_layer(std::unique_ptr<ILayer<T>> layer) {
-            layers_.push_back(std::move(layer));
+            if (out.shape()[0] != Y_batch.shape()[0] || out.shape()[1] != Y_batch.shape()[1]) {
+                return false;
+            }
+
+            LossType<T> loss_fn(out, Y_batch);
+            loss_fn.loss_gradient_into(grad);
+            if (factor != 1.0f) {
+                for (auto& g : grad) g *= factor;
+            }
+            loss = loss_fn.loss();
+
+            utec::algebra::argmax_into(out, 1, predicted);
+            utec::algebra::argmax_into(Y_batch, 1, expected);
+            correct = 0;
+            for (size_t i = 0; i < out.shape()[0]; ++i) {
+                if (predicted[i] == expected[i]) {
+                    correct++;
+                }
+            }
+
+            for (size_t i = layers.size(); i-- > 0;) {
+                if (grad.shape()[0] == 0 || grad.shape()[1] == 0) {
+                    return false;
+                }
+                layers[i]->backward_into(grad, grad_next);
+                std::swap(grad, grad_next);
+            }
+            return grad.shape()[0] != 0 && grad.shape()[1] != 0;
         }
 
-        template<template<typename...> class LossType,
-                 template<typename...> class OptimizerType = SGD>
-        void train(const utec::algebra::Tensor<T,2>& X,
-                   const utec::algebra::Tensor<T,2>& Y,
-                   size_t epochs,
-                   size_t batch_size,
-                   size_t verbose,
-                   T learning_rate)
-        {
+        // Clona las capas en las réplicas que falten y les copia los pesos actuales
+        void prepare_replicas() {
+            if (replicas_.size() != data_parallel_) {
+                replicas_.clear();
+                replicas_.resize(data_parallel_);
+                for (size_t r = 1; r < data_parallel_; ++r)
+                    for (const auto& layer : layers_) replicas_[r].layers.push_back(layer->clone());
+            }
+            for (size_t r = 0; r < data_parallel_; ++r) {
+                replicas_[r].views.clear();
+                for (auto& layer : layers_of(r)) layer->update_params(replicas_[r].views);
+            }
+            broadcast_parameters();
+        }
+
+        // Cada réplica hace forward y backward con su tramo contiguo de filas y copia sus
+        // gradientes; luego se suman en replicas_[0].grads
+        template<template<typename...> class LossType>
+        bool parallel_backpropagate(utec::algebra::TensorView<const T,2> X_batch,
+                                    utec::algebra::TensorView<const T,2> Y_batch,
+                                    float scale, T& loss, size_t& correct) {
+            const size_t rows = X_batch.shape()[0];
+            const size_t shards = std::min(data_parallel_, rows);
+            utec::algebra::thread_pool().parallel_for(shards, [&](size_t r) {
+                const size_t first = rows * r / shards;
+                const size_t last = rows * (r + 1) / shards;
+                Replica& rep = replicas_[r];
+                // Las pérdidas son medias: cada tramo pesa lo que su fracción del lote
+                const float weight = static_cast<float>(last - first) / static_cast<float>(rows);
+                rep.ok = backpropagate<LossType>(layers_of(r), workspace_of(r), X_batch.rows(first, last),
+                                                 Y_batch.rows(first, last), scale * weight, rep.loss, rep.correct);
+                if (!rep.ok) return;
+                rep.loss *= static_cast<T>(weight);
+
+                rep.views.clear();
+                for (auto& layer : layers_of(r)) layer->update_params(rep.views);
+                rep.grads.resize(rep.views.grads.size(), utec::algebra::Tensor<T,2>(0, 0));
+                for (size_t k = 0; k < rep.grads.size(); ++k)
+                    utec::algebra::materialize(rep.views.grads[k], rep.grads[k]);
+            });
+
+            loss = T(0);
+            correct = 0;
+            for (size_t r = 0; r < shards; ++r) {
+                if (!replicas_[r].ok) return false;
+                loss += replicas_[r].loss;
+                correct += replicas_[r].correct;
+            }
+            reduce_gradients(shards);
+            return true;
+        }
+
+        // Suma en árbol (r += r + s con s = 1, 2, 4...) los gradientes de las réplicas
+        // [0, shards) sobre los de la réplica 0. Los hilos se reparten bloques de elementos
+        // y cada bloque sigue siempre ese orden: el resultado no depende del número de hilos
+        void reduce_gradients(size_t shards) {
+            using Acc = utec::algebra::accumulator_t<T>;
+            constexpr size_t block = 4096;
+            auto& total = replicas_[0].grads;
+            size_t tasks = 0;
+            for (const auto& g : total) tasks += (g.size() + block - 1) / block;
+
+            utec::algebra::thread_pool().parallel_for(tasks, [&](size_t t) {
+                size_t k = 0;
+                for (size_t blocks; t >= (blocks = (total[k].size() + block - 1) / block); ++k) t -= blocks;
+                const size_t begin = t * block;
+                const size_t end = std::min(begin + block, total[k].size());
+                for (size_t s = 1; s < shards; s *= 2) {
+                    for (size_t r = 0; r + s < shards; r += 2 * s) {
+                        T* dst = replicas_[r].grads[k].raw_data();
+                        const T* src = replicas_[r + s].grads[k].raw_data();
+                        for (size_t i = begin; i < end; ++i)
+                            dst[i] = static_cast<T>(static_cast<Acc>(dst[i]) + static_cast<Acc>(src[i]));
+                    }
+                }
+            });
+        }
+
+        // Copia los pesos de la red a las demás réplicas
+        void broadcast_parameters() {
+            const auto& master = replicas_[0].views.params;
+            utec::algebra::thread_pool().parallel_for(data_parallel_ - 1, [&](size_t i) {
+                auto& params = replicas_[i + 1].views.params;
+                for (size_t k = 0; k < master.size(); ++k)
+                    std::copy(master[k].data(), master[k].data() + master[k].size(), params[k].data());
+            });
+        }
+
+        // Con réplicas, el optimizador recibe los gradientes ya reducidos
+        void apply_gradients(IOptimizer<T>& optimizer) {
+            if (data_parallel_ > 1) {
+                ReplacedGradients<T> reduced(optimizer, replicas_[0].grads);
+                for (auto& layer : layers_) layer->update_params(reduced);
+            } else {
+                for (auto& layer : layers_) layer->update_params(optimizer);
+            }
+        }
+
+        bool valid_training_input(const utec::algebra::Tensor<T,2>& X,
+                                  const utec::algebra::Tensor<T,2>& Y,
+                                  size_t batch_size) const {
             if (layers_.empty()) {
                 std::cout << "ERROR: No hay capas en la red!\n";
-                return;
+                return false;
             }
 
             if (X.shape()[0] != Y.shape()[0]) {
                 std::cout << "ERROR: Numero de muestras no coincide entre X e Y!\n";
-                return;
+                return false;
             }
 
             if (batch_size == 0 || batch_size > X.shape()[0]) {
                 std::cout << "ERROR: Tamanio de lote invalido!\n";
-                return;
+                return false;
             }
 
             for (size_t i = 0; i < layers_.size(); ++i) {
                 if (!layers_[i]) {
                     std::cout << "ERROR: Capa " << (i + 1) << " es nullptr!\n";
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static void print_epoch(size_t epoch, size_t epochs, size_t num_batches, size_t num_samples,
+                                std::chrono::high_resolution_clock::duration elapsed,
+                                T accuracy, T avg_loss) {
+            auto epoch_time = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+            const double seconds = std::chrono::duration<double>(elapsed).count();
+
+            std::cout << "Epoch " << (epoch + 1) << "/" << epochs << "\n";
+            std::cout << num_batches << "/" << num_batches << " "
+                      << epoch_time.count() << "ms "
+                      << (epoch_time.count() / num_batches) << "ms/step"
+                      << " - " << std::fixed << std::setprecision(0)
+                      << (seconds > 0.0 ? static_cast<double>(num_samples) / seconds : 0.0) << " samples/s"
+                      << " - accuracy: " << std::fixed << std::setprecision(4) << accuracy
+                      << " - loss: " << std::fixed << std::setprecision(4) << avg_loss;
+            std::cout << "\n";
+        }
+
+    public:
+        // Una Dense seguida de ReLU / Sigmoid se guarda como una sola FusedDense
+        void add_layer(std::unique_ptr<ILayer<T>> layer) {
+            replicas_.clear();
+            async_replicas_.clear();
+            if (layer && !layers_.empty() && layers_.back()) {
+                if (auto fused = LayerFactory<T>::fuse(*layers_.back(), *layer)) {
+                    layers_.back() = std::move(fused);
                     return;
                 }
             }
+            layers_.push_back(std::move(layer));
+        }
+
+        // Activa el escalado dinámico de la pérdida en train (recomendado con fp16)
+        void enable_loss_scaling(LossScaler scaler = LossScaler()) {
+            loss_scaler_ = scaler;
+        }
+
+        const LossScaler* loss_scaler() const {
+            return loss_scaler_ ? &*loss_scaler_ : nullptr;
+        }
+
+        // train prepara los lotes en un hilo aparte (BatchPrefetcher): copia, baraja si
+        // options.shuffle y aplica options.transform al lote siguiente mientras entrena el actual
+        void enable_prefetch(BatchPrefetchOptions<T> options = {}) {
+            prefetch_ = std::move(options);
+        }
+
+        void disable_prefetch() { prefetch_.reset(); }
+
+        bool prefetch_enabled() const noexcept { return prefetch_.has_value(); }
+
+        // Entrenamiento síncrono en paralelo de datos: cada lote se reparte entre replicas
+        // copias de la red que se ejecutan en el pool; sus gradientes se suman en árbol y se
+        // aplica un solo paso del optimizador. Con el mismo número de réplicas el resultado es
+        // idéntico bit a bit sea cual sea el número de hilos. 1 (por defecto) lo desactiva
+        void set_data_parallel(size_t replicas) {
+            data_parallel_ = std::max<size_t>(replicas, 1);
+            replicas_.clear();
+        }
+
+        size_t data_parallel() const noexcept { return data_parallel_; }
+
+        size_t num_layers() const noexcept { return layers_.size(); }
+
+        ILayer<T>& layer(size_t i) { return *layers_.at(i); }
+        const ILayer<T>& layer(size_t i) const { return *layers_.at(i); }
+
+        template<template<typename...> class LossType,
+                 template<typename...> class OptimizerType = SGD>
+        void train(const utec::algebra::Tensor<T,2>& X,
+                   const utec::algebra::Tensor<T,2>& Y,
+                   size_t epochs,
+                   size_t batch_size,
+                   size_t verbose,
+                   T learning_rate)
+        {
+            if (!valid_training_input(X, Y, batch_size)) {
+                return;
+            }
 
             OptimizerType<T> opt(learning_rate);
             size_t num_samples = X.shape()[0];
             size_t num_batches = (num_samples + batch_size - 1) / batch_size;
 
+            if (data_parallel_ > 1) {
+                prepare_replicas();
+            }
+
+            std::optional<BatchPrefetcher<T>> prefetcher;
+            if (prefetch_) {
+                prefetcher.emplace(X, Y, batch_size, epochs, *prefetch_);
+            }
+
             for (size_t epoch = 0; epoch < epochs; ++epoch) {
                 auto epoch_start = std::chrono::high_resolution_clock::now();
 
@@ -66,90 +331,43 @@ namespace utec::neural_network {
                 for (size_t batch = 0; batch < num_batches; ++batch) {
                     size_t start_idx = batch * batch_size;
                     size_t end_idx = std::min(start_idx + batch_size, num_samples);
-                    size_t actual_batch_size = end_idx - start_idx;
 
                     try {
-                        utec::algebra::Tensor<T,2> X_batch(actual_batch_size, X.shape()[1]);
-                        utec::algebra::Tensor<T,2> Y_batch(actual_batch_size, Y.shape()[1]);
-
-                        for (size_t i = 0; i < actual_batch_size; ++i) {
-                            if (start_idx + i >= num_samples) {
-                                return;
-                            }
-
-                            for (size_t j = 0; j < X.shape()[1]; ++j) {
-                                X_batch(i, j) = X(start_idx + i, j);
-                            }
-                            for (size_t j = 0; j < Y.shape()[1]; ++j) {
-                                Y_batch(i, j) = Y(start_idx + i, j);
-                            }
+                        std::optional<typename BatchPrefetcher<T>::Batch> fetched;
+                        if (prefetcher) {
+                            fetched = prefetcher->next();
                         }
-
-                        auto out = X_batch;
-                        for (size_t i = 0; i < layers_.size(); ++i) {
-                            out = layers_[i]->forward(out);
+                        auto X_batch = fetched ? fetched->X : utec::algebra::rows(X, start_idx, end_idx);
+                        auto Y_batch = fetched ? fetched->Y : utec::algebra::rows(Y, start_idx, end_idx);
+
+                        const float scale = loss_scaler_ ? loss_scaler_->scale() : 1.0f;
+                        T batch_loss = T(0);
+                        size_t batch_correct = 0;
+                        const bool ok = data_parallel_ > 1
+                            ? parallel_backpropagate<LossType>(X_batch, Y_batch, scale, batch_loss, batch_correct)
+                            : backpropagate<LossType>(layers_, workspace_, X_batch, Y_batch, scale,
+                                                      batch_loss, batch_correct);
+                        // Las capas guardan copia de su entrada: el buffer se puede rellenar ya
+                        if (fetched) {
+                            prefetcher->release(*fetched);
                         }
-
-                        if (out.shape()[0] != Y_batch.shape()[0] || out.shape()[1] != Y_batch.shape()[1]) {
+                        if (!ok) {
                             return;
                         }
-
-                        LossType<T> loss_fn(out, Y_batch);
-                        auto grad = loss_fn.loss_gradient();
-                        T batch_loss = loss_fn.loss();
                         total_loss += batch_loss;
-
-                        for (size_t i = 0; i < actual_batch_size; ++i) {
-                            size_t predicted_class = 0;
-                            T max_pred = out(i, 0);
-                            for (size_t j = 1; j < out.shape()[1]; ++j) {
-                                if (out(i, j) > max_pred) {
-                                    max_pred = out(i, j);
-                                    predicted_class = j;
-                                }
-                            }
-
-                            size_t true_class = 0;
-                            T max_true = Y_batch(i, 0);
-                            for (size_t j = 1; j < Y_batch.shape()[1]; ++j) {
-                                if (Y_batch(i, j) > max_true) {
-                                    max_true = Y_batch(i, j);
-                                    true_class = j;
-                                }
-                            }
-
-                            if (predicted_class == true_class) {
-                                correct_predictions++;
-                            }
+                        correct_predictions += batch_correct;
+
+                        // Con escalado, el paso solo se aplica si todos los gradientes son finitos
+                        // y el optimizador deshace la escala en float, sin redondear a T
+                        if (loss_scaler_) {
+                            GradientCheck<T> check;
+                            apply_gradients(check);
+                            if (!loss_scaler_->update(check.finite)) continue;
+                            opt.set_gradient_scale(1.0f / scale);
                         }
-
-                        if (grad.shape()[0] == 0 || grad.shape()[1] == 0) {
-                            return;
-                        }
-
-                        for (int i = static_cast<int>(layers_.size()) - 1; i >= 0; --i) {
-                            if (!layers_[i]) {
-                                return;
-                            }
-
-                            if (grad.shape()[0] == 0 || grad.shape()[1] == 0) {
-                                return;
-                            }
-
-                            try {
-                                grad = layers_[i]->backward(grad);
-
-                                if (grad.shape()[0] == 0 || grad.shape()[1] == 0) {
-                                    return;
-                                }
-
-                                layers_[i]->update_params(opt);
-
-                            } catch (const std::exception& e) {
-                                return;
-                            } catch (...) {
-                                return;
-                            }
+                        apply_gradients(opt);
+                        if (data_parallel_ > 1) {
+                            broadcast_parameters();
                         }
 
                     } catch (const std::exception& e) {
@@ -160,69 +378,171 @@ namespace utec::neural_network {
                 }
 
                 auto epoch_end = std::chrono::high_resolution_clock::now();
-                auto epoch_time = std::chrono::duration_cast<std::chrono::milliseconds>(epoch_end - epoch_start);
 
                 T avg_loss = total_loss / num_batches;
                 T accuracy = static_cast<T>(correct_predictions) / num_samples;
-
-                std::cout << "Epoch " << (epoch + 1) << "/" << epochs << "\n";
-                std::cout << num_batches << "/" << num_batches << " "
-                          << epoch_time.count() << "ms "
-                          << (epoch_time.count() / num_batches) << "ms/step"
-                          << " - accuracy: " << std::fixed << std::setprecision(4) << accuracy
-                          << " - loss: " << std::fixed << std::setprecision(4) << avg_loss;
-                std::cout << "\n";
+                print_epoch(epoch, epochs, num_batches, num_samples, epoch_end - epoch_start, accuracy, avg_loss);
             }
 
             std::cout << "Entrenamiento completado!\n";
         }
 
-        utec::algebra::Tensor<T,2> predict(const utec::algebra::Tensor<T,2>& X) {
-            if (layers_.empty()) {
-                return utec::algebra::Tensor<T,2>(0, 0);
+        // SGD asíncrono sin bloqueos (Hogwild). threads hilos del pool (0 = todos) toman lotes
+        // disjuntos de un contador atómico; cada uno hace forward y backward con su copia de
+        // las capas y resta lr * grad directamente de los pesos de la red con lecturas y
+        // escrituras atómicas relajadas, sin esperar a los demás. Dos escrituras simultáneas
+        // sobre el mismo peso pueden perder una de ellas y el resultado no es determinista.
+        // Cada hilo se queda con los valores que escribe, así su copia va unos pasos por detrás.
+        // Con verbose > 0 informa cada época, como StaticNetwork::train
+        template<template<typename...> class LossType>
+        void train_async(const utec::algebra::Tensor<T,2>& X,
+                         const utec::algebra::Tensor<T,2>& Y,
+                         size_t epochs,
+                         size_t batch_size,
+                         size_t verbose,
+                         T learning_rate,
+                         size_t threads = 0)
+        {
+            static_assert(std::is_floating_point_v<T>, "train_async necesita pesos float o double");
+            if (!valid_training_input(X, Y, batch_size)) {
+                return;
             }
 
-            utec::algebra::Tensor<T,2> sample_input(1, X.shape()[1]);
-            for (size_t j = 0; j < X.shape()[1]; ++j) {
-                sample_input(0, j) = X(0, j);
+            auto& pool = utec::algebra::thread_pool();
+            const size_t workers = threads > 0 ? std::min(threads, pool.size()) : pool.size();
+            if (async_replicas_.size() != workers) {
+                async_replicas_.clear();
+                async_replicas_.resize(workers);
+                for (auto& rep : async_replicas_)
+                    for (const auto& layer : layers_) rep.layers.push_back(layer->clone());
             }
 
-            auto sample_output = sample_input;
-            for (size_t i = 0; i < layers_.size(); ++i) {
-                sample_output = layers_[i]->forward(sample_output);
+            ParameterViews<T> shared;
+            for (auto& layer : layers_) layer->update_params(shared);
+            for (auto& rep : async_replicas_) {
+                rep.views.clear();
+                for (auto& layer : rep.layers) layer->update_params(rep.views);
+                for (size_t k = 0; k < shared.params.size(); ++k)
+                    std::copy(shared.params[k].data(), shared.params[k].data() + shared.params[k].size(),
+                              rep.views.params[k].data());
             }
 
-            size_t output_size = sample_output.shape()[1];
+            const size_t num_samples = X.shape()[0];
+            const size_t num_batches = (num_samples + batch_size - 1) / batch_size;
 
-            size_t batch_size = 100;
-            size_t num_samples = X.shape()[0];
-            size_t num_batches = (num_samples + batch_size - 1) / batch_size;
-
-            utec::algebra::Tensor<T,2> results(num_samples, output_size);
+            for (size_t epoch = 0; epoch < epochs; ++epoch) {
+                auto epoch_start = std::chrono::high_resolution_clock::now();
+                std::atomic<size_t> next_batch{0};
+
+                auto worker = [&](size_t r) {
+                    Replica& rep = async_replicas_[r];
+                    rep.loss = T(0);
+                    rep.correct = 0;
+                    rep.ok = true;
+                    for (size_t batch; (batch = next_batch.fetch_add(1, std::memory_order_relaxed)) < num_batches;) {
+                        const size_t start_idx = batch * batch_size;
+                        const size_t end_idx = std::min(start_idx + batch_size, num_samples);
+                        T batch_loss = T(0);
+                        size_t batch_correct = 0;
+                        if (!backpropagate<LossType>(rep.layers, rep.workspace,
+                                                     utec::algebra::rows(X, start_idx, end_idx),
+                                                     utec::algebra::rows(Y, start_idx, end_idx),
+                                                     1.0f, batch_loss, batch_correct)) {
+                            rep.ok = false;
+                            return;
+                        }
+                        rep.loss += batch_loss;
+                        rep.correct += batch_correct;
+
+                        rep.views.clear();
+                        for (auto& layer : rep.layers) layer->update_params(rep.views);
+                        for (size_t k = 0; k < shared.params.size(); ++k) {
+                            T* weights = shared.params[k].data();
+                            T* local = rep.views.params[k].data();
+                            const T* grad = rep.views.grads[k].data();
+                            for (size_t i = 0, n = shared.params[k].size(); i < n; ++i) {
+                                std::atomic_ref<T> w(weights[i]);
+                                const T updated = w.load(std::memory_order_relaxed) - learning_rate * grad[i];
+                                w.store(updated, std::memory_order_relaxed);
+                                local[i] = updated;
+                            }
+                        }
+                    }
+                };
 
-            for (size_t batch = 0; batch < num_batches; ++batch) {
-                size_t start_idx = batch * batch_size;
-                size_t end_idx = std::min(start_idx + batch_size, num_samples);
-                size_t actual_batch_size = end_idx - start_idx;
+                try {
+                    pool.parallel_for(workers, worker);
+                } catch (...) {
+                    return;
+                }
 
-                utec::algebra::Tensor<T,2> X_batch(actual_batch_size, X.shape()[1]);
-                for (size_t i = 0; i < actual_batch_size; ++i) {
-                    for (size_t j = 0; j < X.shape()[1]; ++j) {
-                        X_batch(i, j) = X(start_idx + i, j);
-                    }
+                T total_loss = T(0);
+                size_t correct_predictions = 0;
+                for (const auto& rep : async_replicas_) {
+                    if (!rep.ok) return;
+                    total_loss += rep.loss;
+                    correct_predictions += rep.correct;
                 }
 
-                auto out = X_batch;
-                for (size_t i = 0; i < layers_.size(); ++i) {
-                    out = layers_[i]->forward(out);
+                auto epoch_end = std::chrono::high_resolution_clock::now();
+                if (verbose > 0) {
+                    T avg_loss = total_loss / num_batches;
+                    T accuracy = static_cast<T>(correct_predictions) / num_samples;
+                    print_epoch(epoch, epochs, num_batches, num_samples, epoch_end - epoch_start, accuracy, avg_loss);
                 }
+            }
+
+            if (verbose > 0) {
+                std::cout << "Entrenamiento asincrono completado!\n";
+            }
+        }
+
+        // Solo lee la red (forward_inference): se puede llamar desde varios hilos a la vez.
+        // Los lotes se reparten en tramos contiguos entre los hilos del pool; cada tramo
+        // tiene sus propios buffers y escribe sus filas directamente en el resultado.
+        // Con un solo lote no se reparte y es el GEMM el que usa el pool.
+        utec::algebra::Tensor<T,2> predict(const utec::algebra::Tensor<T,2>& X,
+                                           size_t batch_size = 100) const {
+            if (layers_.empty()) {
+                return utec::algebra::Tensor<T,2>(0, 0);
+            }
+            if (batch_size == 0) {
+                throw std::invalid_argument("Batch size must be positive");
+            }
 
-                for (size_t i = 0; i < actual_batch_size; ++i) {
-                    for (size_t j = 0; j < out.shape()[1]; ++j) {
-                        results(start_idx + i, j) = out(i, j);
+            size_t output_size = X.shape()[1];
+            for (const auto& layer : layers_) {
+                output_size = layer->output_width(output_size);
+            }
+
+            const size_t num_samples = X.shape()[0];
+            const size_t num_batches = (num_samples + batch_size - 1) / batch_size;
+            utec::algebra::Tensor<T,2> results(num_samples, output_size);
+
+            auto& pool = utec::algebra::thread_pool();
+            const size_t shards = std::min(num_batches, pool.size());
+            auto run_shard = [&](size_t shard) {
+                const size_t first = num_batches * shard / shards;
+                const size_t last = num_batches * (shard + 1) / shards;
+                utec::algebra::Tensor<T,2> out(0, 0), next(0, 0);
+
+                for (size_t batch = first; batch < last; ++batch) {
+                    const size_t start_idx = batch * batch_size;
+                    const size_t end_idx = std::min(start_idx + batch_size, num_samples);
+
+                    layers_[0]->forward_inference(utec::algebra::rows(X, start_idx, end_idx), out);
+                    for (size_t i = 1; i < layers_.size(); ++i) {
+                        layers_[i]->forward_inference(out, next);
+                        std::swap(out, next);
                     }
+
+                    std::copy(out.raw_data(), out.raw_data() + (end_idx - start_idx) * output_size,
+                              results.raw_data() + start_idx * output_size);
                 }
-            }
+            };
+
+            // Un único tramo corre en este hilo, fuera del pool
+            pool.parallel_for(shards, run_shard);
 
             return results;
         }
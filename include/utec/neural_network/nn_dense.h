@@ -2,48 +2,137 @@
 #define PROG3_NN_FINAL_PROJECT_V2025_01_DENSE_H
 
 #include "nn_interfaces.h"
+#include "activations/nn_activation.h"
 #include "algebra/tensor.h"
+#include "algebra/static_tensor.h"
+#include "algebra/reductions.h"
+#include "algebra/sparse.h"
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 namespace utec::neural_network {
 
+    // Dense<T> decide sus dimensiones en tiempo de ejecución; Dense<T, In, Out> las fija
+    // en compilación y guarda los pesos en StaticTensor
+    template<typename T, size_t In = std::dynamic_extent, size_t Out = std::dynamic_extent>
+    class Dense;
+
+    // Pesos, gradientes y ruta CSR comunes a Dense<T> y FusedDense<T, Activation>.
+    // affine_into hace x * W y deja que el epílogo del GEMM sume el bias (y active)
+    // mientras cada tesela sigue en caché.
     template<typename T>
-    class Dense final : public ILayer<T> {
+    class DenseBase : public ILayer<T> {
+    protected:
+        using Acc = utec::algebra::accumulator_t<T>;
+
         size_t in_f_, out_f_;
-        Tensor<T,2> W_, b_, last_x_, dW_, db_;
+        Tensor<T,2> W_, last_x_, dW_;
+        // Filas 1 x out: en línea, sin memoria del heap mientras quepan
+        utec::algebra::SmallTensor<T,2> b_, db_;
+        // Entradas con pocos no nulos (p. ej. píxeles de fondo) se guardan en CSR y
+        // forward / dW solo recorren los no nulos. Solo con acumulación en el propio T
+        static constexpr bool sparse_capable = std::is_same_v<T, Acc>;
+        utec::algebra::CsrMatrix<T> sparse_x_;
+        double sparse_threshold_ = sparse_capable ? utec::algebra::csr_density_threshold : 0.0;
+        bool sparse_input_ = false;
 
-    public:
         template<typename InitW, typename InitB>
-        Dense(size_t in_f, size_t out_f, InitW init_w, InitB init_b)
+        DenseBase(size_t in_f, size_t out_f, InitW init_w, InitB init_b)
           : in_f_{in_f}, out_f_{out_f},
-            W_(in_f, out_f), b_(1, out_f),
-            dW_(in_f, out_f), db_(1, out_f)
+            W_(in_f, out_f), dW_(in_f, out_f),
+            b_(1, out_f), db_(1, out_f)
         {
             init_w(W_);
-            init_b(b_);
+            // Los inicializadores reciben un Tensor<T,2>, como el resto de la API
+            Tensor<T,2> b(1, out_f);
+            init_b(b);
+            std::copy(b.raw_data(), b.raw_data() + b.size(), b_.raw_data());
         }
 
-        Tensor<T,2> forward(const Tensor<T,2>& x) override {
-            last_x_ = x;
-            auto y = utec::algebra::matrix_product(x, W_);
-            auto s = y.shape();
-            for (size_t i = 0; i < s[0]; ++i)
-                for (size_t j = 0; j < s[1]; ++j)
-                    y(i,j) += b_(0,j);
-            return y;
+        // y = x * W; ep(i, j, fila, cols) recibe cada tramo de fila de y en Acc
+        template<typename Epilogue>
+        void affine_into(TensorView<const T,2> x, Tensor<T,2>& y, const Epilogue& ep) {
+            sparse_input_ = sparse_threshold_ > 0.0 && utec::algebra::density(x) < sparse_threshold_;
+            if (sparse_threshold_ > 0.0) {
+                // Ambas rutas quedan con memoria para este lote: pasar de una a otra entre
+                // pasos (p. ej. tras una ReLU) no reserva
+                sparse_x_.reserve(x.shape()[0], x.shape()[1]);
+                last_x_.reshape(x.shape());
+            }
+            if constexpr (sparse_capable) {
+                if (sparse_input_) {
+                    sparse_x_.assign(x);
+                    utec::algebra::sparse_matrix_product_into(sparse_x_, W_, y);
+                    for (size_t i = 0; i < y.shape()[0]; ++i)
+                        ep(i, 0, y.raw_data() + i * out_f_, out_f_);
+                    return;
+                }
+            }
+            utec::algebra::materialize(x, last_x_);
+            utec::algebra::matrix_product_into(last_x_, W_, y, ep);
         }
 
-        Tensor<T,2> backward(const Tensor<T,2>& grad) override {
-            Tensor<T,2> x_t = utec::algebra::transpose_2d(last_x_);
-            dW_ = utec::algebra::matrix_product(x_t, grad);
+        // Como affine_into, pero sin guardar la entrada: x se lee en su sitio y el CSR
+        // vive en memoria de cada hilo
+        template<typename Epilogue>
+        void affine_inference(TensorView<const T,2> x, Tensor<T,2>& y, const Epilogue& ep) const {
+            if constexpr (sparse_capable) {
+                if (sparse_threshold_ > 0.0 && utec::algebra::density(x) < sparse_threshold_) {
+                    thread_local utec::algebra::CsrMatrix<T> csr;
+                    csr.assign(x);
+                    utec::algebra::sparse_matrix_product_into(csr, W_, y);
+                    for (size_t i = 0; i < y.shape()[0]; ++i)
+                        ep(i, 0, y.raw_data() + i * out_f_, out_f_);
+                    return;
+                }
+            }
+            utec::algebra::matrix_product_into(x, W_, y, ep);
+        }
 
-            db_.fill(T(0));
-            auto s = grad.shape();
-            for (size_t i = 0; i < s[0]; ++i)
-                for (size_t j = 0; j < s[1]; ++j)
-                    db_(0,j) += grad(i,j);
+        // dW = xᵀ * dz y out = dz * Wᵀ; db lo calcula cada capa
+        void linear_backward_into(TensorView<const T,2> dz, Tensor<T,2>& out) {
+            if (sparse_input_) {
+                utec::algebra::sparse_matrix_product_tn_into(sparse_x_, dz, dW_);
+            } else {
+                utec::algebra::matrix_product_tn_into(last_x_, dz, dW_);
+            }
+            utec::algebra::matrix_product_nt_into(dz, W_, out);
+        }
 
-            Tensor<T,2> w_t = utec::algebra::transpose_2d(W_);
-            return utec::algebra::matrix_product(grad, w_t);
+    public:
+        size_t input_size() const noexcept { return in_f_; }
+        size_t output_size() const noexcept { return out_f_; }
+
+        size_t output_width(size_t input_width) const override {
+            if (input_width != in_f_) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            return out_f_;
+        }
+
+        const Tensor<T,2>& weights() const noexcept { return W_; }
+        const utec::algebra::SmallTensor<T,2>& bias() const noexcept { return b_; }
+
+        // Densidad de entrada bajo la cual se usa CSR; 0 desactiva la ruta dispersa
+        void set_sparse_threshold(double threshold) noexcept {
+            sparse_threshold_ = sparse_capable ? threshold : 0.0;
+        }
+        double sparse_threshold() const noexcept { return sparse_threshold_; }
+        // Si el último forward usó la entrada en CSR
+        bool sparse_input() const noexcept { return sparse_input_; }
+
+        Tensor<T,2> forward(TensorView<const T,2> x) override {
+            Tensor<T,2> y(0, 0);
+            this->forward_into(x, y);
+            return y;
+        }
+
+        Tensor<T,2> backward(TensorView<const T,2> grad) override {
+            Tensor<T,2> out(0, 0);
+            this->backward_into(grad, out);
+            return out;
         }
 
         void update_params(IOptimizer<T>& opt) override {
@@ -52,6 +141,253 @@ namespace utec::neural_network {
         }
     };
 
+    template<typename T>
+    class Dense<T, std::dynamic_extent, std::dynamic_extent> final : public DenseBase<T> {
+        using Acc = typename DenseBase<T>::Acc;
+
+        auto bias_epilogue() const {
+            const T* b = this->b_.raw_data();
+            return [b](size_t, size_t j, Acc* row, size_t cols) {
+                if constexpr (std::is_same_v<T, float>) {
+                    utec::algebra::add_bias(row, b + j, cols);
+                } else {
+                    for (size_t c = 0; c < cols; ++c) row[c] += static_cast<Acc>(b[j + c]);
+                }
+            };
+        }
+
+    public:
+        template<typename InitW, typename InitB>
+        Dense(size_t in_f, size_t out_f, InitW init_w, InitB init_b)
+          : DenseBase<T>(in_f, out_f, init_w, init_b) {}
+
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Dense>(*this); }
+
+        void forward_into(TensorView<const T,2> x, Tensor<T,2>& y) override {
+            this->affine_into(x, y, bias_epilogue());
+        }
+
+        void forward_inference(TensorView<const T,2> x, Tensor<T,2>& y) const override {
+            this->affine_inference(x, y, bias_epilogue());
+        }
+
+        void backward_into(TensorView<const T,2> grad, Tensor<T,2>& out) override {
+            utec::algebra::reduce_sum_into(grad, 0, TensorView<T,2>(this->db_));
+            this->linear_backward_into(grad, out);
+        }
+    };
+
+    // Dense seguida de una activación (ReLU o Sigmoid) en una sola capa. El epílogo del
+    // GEMM suma el bias, activa y guarda la salida para el backward; el backward calcula
+    // dZ = grad ⊙ f'(y) y db en una sola pasada antes de los dos GEMM del gradiente.
+    template<typename T, template<typename> class Activation>
+    class FusedDense final : public DenseBase<T> {
+        using Acc = typename DenseBase<T>::Acc;
+        using Act = Activation<Acc>;
+        // ReLU en float usa los kernels sin ramas de gemm.h
+        static constexpr bool simd_relu = std::is_same_v<T, float> && std::is_same_v<Act, ReLU<float>>;
+
+        Tensor<T,2> last_y_, dz_;
+        std::vector<Acc> db_acc_;
+
+        // Suma el bias y activa un tramo de fila; si kept no es nulo guarda ahí la salida
+        static void activate_row(const T* b, Acc* row, size_t cols, T* kept) {
+            if constexpr (simd_relu) {
+                utec::algebra::add_bias(row, b, cols, true, kept);
+                return;
+            }
+            for (size_t c = 0; c < cols; ++c) {
+                const Acc v = Act::activate(row[c] + static_cast<Acc>(b[c]));
+                row[c] = v;
+                if (kept) kept[c] = static_cast<T>(v);
+            }
+        }
+
+    public:
+        template<typename InitW, typename InitB>
+        FusedDense(size_t in_f, size_t out_f, InitW init_w, InitB init_b)
+          : DenseBase<T>(in_f, out_f, init_w, init_b), db_acc_(out_f) {}
+
+        // Copia pesos, bias y umbral CSR de una Dense existente
+        explicit FusedDense(const Dense<T>& dense)
+          : FusedDense(dense.input_size(), dense.output_size(),
+                       [&](Tensor<T,2>& w) { w = dense.weights(); },
+                       [&](Tensor<T,2>& b) {
+                           std::copy(dense.bias().raw_data(), dense.bias().raw_data() + b.size(), b.raw_data());
+                       })
+        {
+            this->set_sparse_threshold(dense.sparse_threshold());
+        }
+
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<FusedDense>(*this); }
+
+        void forward_into(TensorView<const T,2> x, Tensor<T,2>& y) override {
+            const size_t n = this->out_f_;
+            last_y_.reshape({x.shape()[0], n});
+            const T* b = this->b_.raw_data();
+            T* kept = last_y_.raw_data();
+            this->affine_into(x, y, [b, kept, n](size_t i, size_t j, Acc* row, size_t cols) {
+                activate_row(b + j, row, cols, kept + i * n + j);
+            });
+        }
+
+        void forward_inference(TensorView<const T,2> x, Tensor<T,2>& y) const override {
+            const T* b = this->b_.raw_data();
+            this->affine_inference(x, y, [b](size_t, size_t j, Acc* row, size_t cols) {
+                activate_row(b + j, row, cols, nullptr);
+            });
+        }
+
+        void backward_into(TensorView<const T,2> grad, Tensor<T,2>& out) override {
+            const size_t m = grad.shape()[0], n = grad.shape()[1];
+            if (n != this->out_f_ || m != last_y_.shape()[0]) {
+                throw std::invalid_argument("Gradient shape does not match the last forward pass");
+            }
+            dz_.reshape({m, n});
+            const T* g = grad.data();
+            if (!grad.is_contiguous()) {
+                utec::algebra::materialize(grad, dz_);
+                g = dz_.raw_data();
+            }
+            const T* y = last_y_.raw_data();
+            T* dz = dz_.raw_data();
+            Acc* db = db_acc_.data();
+            std::fill(db, db + n, Acc(0));
+            for (size_t i = 0; i < m; ++i) {
+                if constexpr (simd_relu) {
+                    utec::algebra::relu_grad(g + i * n, y + i * n, n, dz + i * n, db);
+                    continue;
+                }
+                for (size_t j = 0; j < n; ++j) {
+                    const Acc d = static_cast<Acc>(g[i * n + j]) * Act::derivative(static_cast<Acc>(y[i * n + j]));
+                    dz[i * n + j] = static_cast<T>(d);
+                    db[j] += d;
+                }
+            }
+            T* db_out = this->db_.raw_data();
+            for (size_t j = 0; j < n; ++j) db_out[j] = static_cast<T>(db[j]);
+
+            this->linear_backward_into(dz_, out);
+        }
+    };
+
+    template<typename T, size_t In, size_t Out>
+    class Dense final : public ILayer<T> {
+        static_assert(In != std::dynamic_extent && Out != std::dynamic_extent,
+                      "Dense necesita ambas dimensiones fijas o ambas dinámicas");
+
+        // Con matrices pequeñas ganan los kernels de tamaño fijo; con grandes, el GEMM
+        static constexpr bool small_kernels = In * Out <= utec::algebra::static_kernel_max_work;
+
+        utec::algebra::StaticTensor<T, In, Out> W_, dW_;
+        utec::algebra::StaticTensor<T, Out, In> Wt_;
+        utec::algebra::StaticTensor<T, 1, Out> b_, db_;
+        Tensor<T,2> last_x_;
+
+    public:
+        // Los inicializadores reciben un Tensor<T,2> como en Dense<T>
+        template<typename InitW, typename InitB>
+        Dense(InitW init_w, InitB init_b) {
+            Tensor<T,2> w(In, Out), b(1, Out);
+            init_w(w);
+            init_b(b);
+            W_ = utec::algebra::StaticTensor<T, In, Out>(w);
+            b_ = utec::algebra::StaticTensor<T, 1, Out>(b);
+        }
+
+        static constexpr size_t input_size() noexcept { return In; }
+        static constexpr size_t output_size() noexcept { return Out; }
+
+        size_t output_width(size_t input_width) const override {
+            if (input_width != In) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            return Out;
+        }
+
+        std::unique_ptr<ILayer<T>> clone() const override { return std::make_unique<Dense>(*this); }
+
+        const utec::algebra::StaticTensor<T, In, Out>& weights() const noexcept { return W_; }
+        const utec::algebra::StaticTensor<T, 1, Out>& bias() const noexcept { return b_; }
+
+        Tensor<T,2> forward(TensorView<const T,2> x) override {
+            Tensor<T,2> y(0, 0);
+            forward_into(x, y);
+            return y;
+        }
+
+        Tensor<T,2> backward(TensorView<const T,2> grad) override {
+            Tensor<T,2> out(0, 0);
+            backward_into(grad, out);
+            return out;
+        }
+
+        void forward_into(TensorView<const T,2> x, Tensor<T,2>& y) override {
+            if (x.shape()[1] != In) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            utec::algebra::materialize(x, last_x_);
+            forward_inference(last_x_, y);
+        }
+
+        void forward_inference(TensorView<const T,2> x, Tensor<T,2>& y) const override {
+            if (x.shape()[1] != In) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            const size_t rows = x.shape()[0];
+            y.reshape({rows, Out});
+            if constexpr (small_kernels) {
+                // Los kernels fijos leen filas contiguas
+                if (!x.is_contiguous()) {
+                    thread_local Tensor<T,2> packed(0, 0);
+                    utec::algebra::materialize(x, packed);
+                    x = packed;
+                }
+                utec::algebra::detail::static_affine_rows<In, Out>(rows, x.data(), In,
+                                                                   W_.data(), b_.data(), y.raw_data());
+            } else {
+                TensorView<const T,2> wv = W_;
+                utec::algebra::detail::gemm_strided(rows, Out, In, utec::algebra::detail::as_strided(x),
+                                                    utec::algebra::detail::as_strided(wv),
+                                                    y.raw_data(), Out, false);
+                T* yp = y.raw_data();
+                const T* bp = b_.data();
+                for (size_t r = 0; r < rows; ++r)
+                    for (size_t j = 0; j < Out; ++j) yp[r * Out + j] += bp[j];
+            }
+        }
+
+        void backward_into(TensorView<const T,2> grad, Tensor<T,2>& out) override {
+            if (grad.shape()[1] != Out || grad.shape()[0] != last_x_.shape()[0]) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+            const size_t rows = grad.shape()[0];
+            out.reshape({rows, In});
+            if (small_kernels && grad.is_contiguous()) {
+                utec::algebra::detail::static_weight_grad<In, Out>(rows, last_x_.raw_data(), In,
+                                                                   grad.data(), Out, dW_.data());
+                utec::algebra::transpose(In, Out, W_.data(), Out, Wt_.data(), In);
+                utec::algebra::detail::static_input_grad<In, Out>(rows, grad.data(), Out,
+                                                                  Wt_.data(), out.raw_data());
+            } else {
+                TensorView<const T,2> xv = last_x_, wv = W_;
+                utec::algebra::detail::gemm_strided(In, Out, rows, utec::algebra::detail::as_strided(xv, true),
+                                                    utec::algebra::detail::as_strided(grad),
+                                                    dW_.data(), Out, false);
+                utec::algebra::detail::gemm_strided(rows, In, Out, utec::algebra::detail::as_strided(grad),
+                                                    utec::algebra::detail::as_strided(wv, true),
+                                                    out.raw_data(), In, false);
+            }
+
+            utec::algebra::reduce_sum_into(grad, 0, db_.view());
+        }
+
+        void update_params(IOptimizer<T>& opt) override {
+            opt.update(W_, dW_);
+            opt.update(b_, db_);
+        }
+    };
+
 }
 
 #endif // PROG3_NN_FINAL_PROJECT_V2025_01_DENSE_H
@@ -2,24 +2,44 @@
 #define PROG3_NN_FINAL_PROJECT_V2025_01_LAYER_H
 
 #include "algebra/tensor.h"
+#include "algebra/tensor_view.h"
+#include <memory>
 
 namespace utec::neural_network {
 
   template<typename T, size_t DIMS>
   using Tensor = utec::algebra::Tensor<T, DIMS>;
 
+  template<typename T, size_t DIMS>
+  using TensorView = utec::algebra::TensorView<T, DIMS>;
+
   template<typename T>
   struct IOptimizer {
     virtual ~IOptimizer() = default;
-    virtual void update(Tensor<T,2>& params, const Tensor<T,2>& gradients) = 0;
+    // Recibe vistas contiguas: así vale cualquier almacenamiento (Tensor o StaticTensor)
+    virtual void update(TensorView<T,2> params, TensorView<const T,2> gradients) = 0;
     virtual void step() {}
+    // Factor por el que se multiplican los gradientes antes de usarlos (1 / escala de la
+    // pérdida). Se aplica ya en la precisión del estado, no en T
+    virtual void set_gradient_scale(float) {}
   };
 
   template<typename T>
   struct ILayer {
     virtual ~ILayer() = default;
-    virtual Tensor<T,2> forward(const Tensor<T,2>& x) = 0;
-    virtual Tensor<T,2> backward(const Tensor<T,2>& gradients) = 0;
+    virtual Tensor<T,2> forward(TensorView<const T,2> x) = 0;
+    virtual Tensor<T,2> backward(TensorView<const T,2> gradients) = 0;
+
+    // Escriben en un buffer del llamador; out no debe compartir memoria con la entrada
+    virtual void forward_into(TensorView<const T,2> x, Tensor<T,2>& out) { out = forward(x); }
+    virtual void backward_into(TensorView<const T,2> gradients, Tensor<T,2>& out) { out = backward(gradients); }
+    // Forward de solo inferencia: no guarda nada para el backward ni modifica la capa,
+    // así varios hilos pueden usar la misma red a la vez (cada uno con su out)
+    virtual void forward_inference(TensorView<const T,2> x, Tensor<T,2>& out) const = 0;
+    // Columnas de la salida para una entrada de input_width columnas, sin hacer el forward
+    virtual size_t output_width(size_t input_width) const { return input_width; }
+    // Copia independiente (pesos incluidos); la usan las réplicas del entrenamiento en paralelo
+    virtual std::unique_ptr<ILayer<T>> clone() const = 0;
     virtual void update_params(IOptimizer<T>& optimizer) {}
   };
 
@@ -28,6 +48,7 @@ namespace utec::neural_network {
     virtual ~ILoss() = default;
     virtual T loss() const = 0;
     virtual Tensor<T,DIMS> loss_gradient() const = 0;
+    virtual void loss_gradient_into(Tensor<T,DIMS>& grad) const { grad = loss_gradient(); }
   };
 
 }
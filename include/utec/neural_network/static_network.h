@@ -0,0 +1,280 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_STATIC_NETWORK_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_STATIC_NETWORK_H
+
+#include "nn_interfaces.h"
+#include "nn_dense.h"
+#include "activations/nn_activation.h"
+#include "optimizers/nn_optimizer.h"
+#include "algebra/tensor.h"
+#include "algebra/reductions.h"
+#include "algebra/thread_pool.h"
+#include <array>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <type_traits>
+
+// Red con las capas fijadas en compilación: StaticNetwork<T, FusedDense<T, ReLU>, Dense<T>, ...>
+// guarda las capas por valor en un std::tuple y las recorre con fold expressions. Cada
+// llamada se hace con el nombre calificado de la clase (layer.L::forward_into), así que no
+// pasa por la vtable y el compilador puede inlinear a través de las capas. Los anchos se
+// comprueban una vez: en compilación los de Dense<T, In, Out> y en el constructor el resto.
+namespace utec::neural_network {
+
+    namespace detail {
+
+        // Anchos conocidos en compilación (0 = desconocido); same = la capa no cambia el ancho
+        template<typename L>
+        struct layer_widths {
+            static constexpr size_t in = 0, out = 0;
+            static constexpr bool same = false;
+        };
+
+        template<typename T, size_t In, size_t Out>
+        struct layer_widths<Dense<T, In, Out>> {
+            static constexpr size_t in = In == std::dynamic_extent ? 0 : In;
+            static constexpr size_t out = Out == std::dynamic_extent ? 0 : Out;
+            static constexpr bool same = false;
+        };
+
+        template<typename T>
+        struct layer_widths<ReLU<T>> : layer_widths<void> {
+            static constexpr bool same = true;
+        };
+
+        template<typename T>
+        struct layer_widths<Sigmoid<T>> : layer_widths<void> {
+            static constexpr bool same = true;
+        };
+
+        template<typename... Layers>
+        constexpr bool compatible_widths() {
+            constexpr std::array<size_t, sizeof...(Layers)> ins{layer_widths<Layers>::in...};
+            constexpr std::array<size_t, sizeof...(Layers)> outs{layer_widths<Layers>::out...};
+            constexpr std::array<bool, sizeof...(Layers)> same{layer_widths<Layers>::same...};
+            size_t width = 0;
+            for (size_t i = 0; i < sizeof...(Layers); ++i) {
+                if (ins[i] != 0 && width != 0 && ins[i] != width) return false;
+                if (!same[i]) width = outs[i];
+            }
+            return true;
+        }
+
+    }
+
+    template<typename T, typename... Layers>
+    class StaticNetwork {
+        static_assert(sizeof...(Layers) > 0, "StaticNetwork necesita al menos una capa");
+        static_assert((std::is_base_of_v<ILayer<T>, Layers> && ...), "Las capas deben implementar ILayer<T>");
+        static_assert(detail::compatible_widths<Layers...>(),
+                      "Las dimensiones fijas de capas consecutivas no coinciden");
+
+        static constexpr size_t N = sizeof...(Layers);
+        using LayerTuple = std::tuple<Layers...>;
+        using Indices = std::make_index_sequence<N>;
+        using Buffers = std::array<utec::algebra::Tensor<T,2>, 2>;
+
+        template<size_t I>
+        using layer_t = std::tuple_element_t<I, LayerTuple>;
+
+        LayerTuple layers_;
+        // 0 = sin capa con ancho propio: la red acepta cualquier ancho y lo conserva
+        size_t input_width_ = 0, output_width_ = 0;
+        // La capa I escribe en act_[I % 2] y lee de act_[(I - 1) % 2]; igual grad_ hacia atrás
+        Buffers act_{utec::algebra::Tensor<T,2>(0, 0), utec::algebra::Tensor<T,2>(0, 0)};
+        Buffers grad_{utec::algebra::Tensor<T,2>(0, 0), utec::algebra::Tensor<T,2>(0, 0)};
+        utec::algebra::Tensor<size_t,2> predicted_{0, 0}, expected_{0, 0};
+
+        // Encadena output_width desde la primera capa que conoce su entrada; lanza si no encajan
+        template<typename L>
+        size_t next_width(const L& layer, size_t width) {
+            if constexpr (requires { layer.input_size(); }) {
+                if (width == 0) {
+                    input_width_ = layer.input_size();
+                    width = input_width_;
+                }
+            }
+            return width == 0 ? 0 : layer.L::output_width(width);
+        }
+
+        template<size_t I>
+        void forward_layer(TensorView<const T,2> x) {
+            using L = layer_t<I>;
+            L& layer = std::get<I>(layers_);
+            if constexpr (I == 0) layer.L::forward_into(x, act_[0]);
+            else layer.L::forward_into(act_[(I - 1) % 2], act_[I % 2]);
+        }
+
+        template<size_t I>
+        void infer_layer(TensorView<const T,2> x, Buffers& buf) const {
+            using L = layer_t<I>;
+            const L& layer = std::get<I>(layers_);
+            if constexpr (I == 0) layer.L::forward_inference(x, buf[0]);
+            else layer.L::forward_inference(buf[(I - 1) % 2], buf[I % 2]);
+        }
+
+        // Paso J hacia atrás: la capa N - 1 - J lee grad_[J % 2] y escribe grad_[(J + 1) % 2]
+        template<size_t J>
+        void backward_layer() {
+            using L = layer_t<N - 1 - J>;
+            std::get<N - 1 - J>(layers_).L::backward_into(grad_[J % 2], grad_[(J + 1) % 2]);
+        }
+
+        template<size_t... I>
+        const utec::algebra::Tensor<T,2>& forward_all(TensorView<const T,2> x, std::index_sequence<I...>) {
+            (forward_layer<I>(x), ...);
+            return act_[(N - 1) % 2];
+        }
+
+        template<size_t... I>
+        const utec::algebra::Tensor<T,2>& infer_all(TensorView<const T,2> x, Buffers& buf,
+                                                    std::index_sequence<I...>) const {
+            (infer_layer<I>(x, buf), ...);
+            return buf[(N - 1) % 2];
+        }
+
+        template<size_t... J>
+        void backward_all(std::index_sequence<J...>) {
+            (backward_layer<J>(), ...);
+        }
+
+        template<size_t I>
+        void update_layer(IOptimizer<T>& optimizer) {
+            using L = layer_t<I>;
+            std::get<I>(layers_).L::update_params(optimizer);
+        }
+
+        template<size_t... I>
+        void update_all(IOptimizer<T>& optimizer, std::index_sequence<I...>) {
+            (update_layer<I>(optimizer), ...);
+        }
+
+        size_t count_correct(const utec::algebra::Tensor<T,2>& out, TensorView<const T,2> Y_batch) {
+            utec::algebra::argmax_into(out, 1, predicted_);
+            utec::algebra::argmax_into(Y_batch, 1, expected_);
+            size_t correct = 0;
+            for (size_t i = 0; i < out.shape()[0]; ++i) {
+                if (predicted_[i] == expected_[i]) correct++;
+            }
+            return correct;
+        }
+
+    public:
+        explicit StaticNetwork(Layers... layers) : layers_(std::move(layers)...) {
+            size_t width = 0;
+            std::apply([&](const auto&... layer) { ((width = next_width(layer, width)), ...); }, layers_);
+            output_width_ = width;
+        }
+
+        static constexpr size_t num_layers() noexcept { return N; }
+
+        size_t input_width() const noexcept { return input_width_; }
+        size_t output_width() const noexcept { return output_width_; }
+
+        template<size_t I>
+        layer_t<I>& layer() noexcept { return std::get<I>(layers_); }
+
+        template<size_t I>
+        const layer_t<I>& layer() const noexcept { return std::get<I>(layers_); }
+
+        // Mismo algoritmo que NeuralNetwork::train, pero las entradas se comprueban una vez
+        // aquí (lanza std::invalid_argument) y el bucle de lotes no vuelve a validar nada
+        template<template<typename...> class LossType,
+                 template<typename...> class OptimizerType = SGD>
+        void train(const utec::algebra::Tensor<T,2>& X,
+                   const utec::algebra::Tensor<T,2>& Y,
+                   size_t epochs,
+                   size_t batch_size,
+                   size_t verbose,
+                   T learning_rate)
+        {
+            const size_t num_samples = X.shape()[0];
+            if (Y.shape()[0] != num_samples) {
+                throw std::invalid_argument("X and Y must have the same number of samples");
+            }
+            if (batch_size == 0 || batch_size > num_samples) {
+                throw std::invalid_argument("Batch size must be between 1 and the number of samples");
+            }
+            const size_t out_width = output_width_ != 0 ? output_width_ : X.shape()[1];
+            if ((input_width_ != 0 && X.shape()[1] != input_width_) || Y.shape()[1] != out_width) {
+                throw std::invalid_argument("Training data does not match the network dimensions");
+            }
+
+            OptimizerType<T> opt(learning_rate);
+            const size_t num_batches = (num_samples + batch_size - 1) / batch_size;
+
+            for (size_t epoch = 0; epoch < epochs; ++epoch) {
+                T total_loss = T(0);
+                size_t correct_predictions = 0;
+
+                for (size_t batch = 0; batch < num_batches; ++batch) {
+                    const size_t start_idx = batch * batch_size;
+                    const size_t end_idx = std::min(start_idx + batch_size, num_samples);
+                    auto X_batch = utec::algebra::rows(X, start_idx, end_idx);
+                    auto Y_batch = utec::algebra::rows(Y, start_idx, end_idx);
+
+                    const auto& out = forward_all(X_batch, Indices{});
+                    LossType<T> loss_fn(out, Y_batch);
+                    loss_fn.loss_gradient_into(grad_[0]);
+                    total_loss += loss_fn.loss();
+                    correct_predictions += count_correct(out, Y_batch);
+
+                    backward_all(Indices{});
+                    update_all(opt, Indices{});
+                }
+
+                if (verbose > 0) {
+                    std::cout << "Epoch " << (epoch + 1) << "/" << epochs
+                              << " - accuracy: " << std::fixed << std::setprecision(4)
+                              << static_cast<T>(correct_predictions) / num_samples
+                              << " - loss: " << std::fixed << std::setprecision(4)
+                              << total_loss / num_batches << "\n";
+                }
+            }
+
+            if (verbose > 0) {
+                std::cout << "Entrenamiento completado!\n";
+            }
+        }
+
+        // Como NeuralNetwork::predict: const, tramos contiguos de lotes repartidos en el pool
+        utec::algebra::Tensor<T,2> predict(const utec::algebra::Tensor<T,2>& X,
+                                           size_t batch_size = 100) const {
+            if (batch_size == 0) {
+                throw std::invalid_argument("Batch size must be positive");
+            }
+            if (input_width_ != 0 && X.shape()[1] != input_width_) {
+                throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+            }
+
+            const size_t output_size = output_width_ != 0 ? output_width_ : X.shape()[1];
+            const size_t num_samples = X.shape()[0];
+            const size_t num_batches = (num_samples + batch_size - 1) / batch_size;
+            utec::algebra::Tensor<T,2> results(num_samples, output_size);
+
+            auto& pool = utec::algebra::thread_pool();
+            const size_t shards = std::min(num_batches, pool.size());
+            pool.parallel_for(shards, [&](size_t shard) {
+                const size_t first = num_batches * shard / shards;
+                const size_t last = num_batches * (shard + 1) / shards;
+                Buffers buf{utec::algebra::Tensor<T,2>(0, 0), utec::algebra::Tensor<T,2>(0, 0)};
+
+                for (size_t batch = first; batch < last; ++batch) {
+                    const size_t start_idx = batch * batch_size;
+                    const size_t end_idx = std::min(start_idx + batch_size, num_samples);
+                    const auto& out = infer_all(utec::algebra::rows(X, start_idx, end_idx), buf, Indices{});
+                    std::copy(out.raw_data(), out.raw_data() + (end_idx - start_idx) * output_size,
+                              results.raw_data() + start_idx * output_size);
+                }
+            });
+
+            return results;
+        }
+    };
+
+}
+
+#endif // PROG3_NN_FINAL_PROJECT_V2025_01_STATIC_NETWORK_H
@@ -3,35 +3,74 @@
 
 #include "neural_network/nn_interfaces.h"
 #include <cmath>
+#include <algorithm>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 namespace utec::neural_network {
+
+    // Hiperparámetros y estado de los optimizadores: float cuando T es bf16 / fp16
+    template<typename T>
+    using state_t = utec::algebra::accumulator_t<T>;
+
+    namespace detail {
+
+        // Pesos maestros: copia en float de unos parámetros de 16 bits, identificada por su
+        // dirección. Se actualiza la copia y se redondea a 16 bits después, porque lr * g
+        // suele ser menor que la resolución de bf16 y se perdería al restarlo directamente.
+        template<typename T>
+        float* master_weights(std::unordered_map<void*, std::vector<float>>& masters, TensorView<T,2> params) {
+            auto& w = masters[static_cast<void*>(params.data())];
+            if (w.size() != params.size()) {
+                w.resize(params.size());
+                utec::algebra::convert(params.data(), w.data(), params.size());
+            }
+            return w.data();
+        }
+
+    }
+
     template<typename T>
     struct SGD final : IOptimizer<T> {
-        T lr_;
-        explicit SGD(T lr = T(0.01)) : lr_{lr} {}
+        state_t<T> lr_;
+        state_t<T> grad_scale_ = state_t<T>(1);
+        std::unordered_map<void*, std::vector<float>> masters_;
+        explicit SGD(state_t<T> lr = state_t<T>(0.01)) : lr_{lr} {}
+
+        void set_gradient_scale(float scale) override { grad_scale_ = scale; }
 
-        void update(Tensor<T,2>& params,
-                    const Tensor<T,2>& grads) override
+        void update(TensorView<T,2> params,
+                    TensorView<const T,2> grads) override
         {
             auto n = params.size();
-            for (size_t i = 0; i < n; ++i)
-                params[i] -= lr_ * grads[i];
+            T* p = params.data();
+            const T* g = grads.data();
+            if constexpr (utec::algebra::is_half_v<T>) {
+                float* w = detail::master_weights(masters_, params);
+                for (size_t i = 0; i < n; ++i) {
+                    w[i] -= lr_ * (static_cast<float>(g[i]) * grad_scale_);
+                    p[i] = w[i];
+                }
+            } else {
+                for (size_t i = 0; i < n; ++i)
+                    p[i] -= lr_ * (g[i] * grad_scale_);
+            }
         }
     };
 
+    // Los momentos de los bias caben en línea; los de las matrices de pesos van al heap
     template<typename T>
     struct AdamState {
-        Tensor<T,2> m_;
-        Tensor<T,2> v_;
+        utec::algebra::SmallTensor<T,2> m_;
+        utec::algebra::SmallTensor<T,2> v_;
         size_t t_;
 
         AdamState() : t_(0) {}
 
         void initialize(const std::array<size_t,2>& shape) {
-            m_ = Tensor<T,2>(shape);
-            v_ = Tensor<T,2>(shape);
+            m_ = utec::algebra::SmallTensor<T,2>(shape);
+            v_ = utec::algebra::SmallTensor<T,2>(shape);
             m_.fill(T(0));
             v_.fill(T(0));
             t_ = 0;
@@ -44,33 +83,39 @@ namespace utec::neural_network {
 
     template<typename T>
     struct Adam final : IOptimizer<T> {
-        T lr_, beta1_, beta2_, eps_;
-        std::unordered_map<void*, std::unique_ptr<AdamState<T>>> states_;
+        using S = state_t<T>;
+        S lr_, beta1_, beta2_, eps_;
+        S grad_scale_ = S(1);
+        std::unordered_map<void*, std::unique_ptr<AdamState<S>>> states_;
+        std::unordered_map<void*, std::vector<float>> masters_;
 
-        explicit Adam(T learning_rate = T(0.001),
-                      T beta1 = T(0.9),
-                      T beta2 = T(0.999),
-                      T epsilon = T(1e-8))
+        explicit Adam(S learning_rate = S(0.001),
+                      S beta1 = S(0.9),
+                      S beta2 = S(0.999),
+                      S epsilon = S(1e-8))
           : lr_{learning_rate}
           , beta1_{beta1}
           , beta2_{beta2}
           , eps_{epsilon}
         {}
 
-        void update(Tensor<T,2>& params,
-                    const Tensor<T,2>& grads) override
+        void set_gradient_scale(float scale) override { grad_scale_ = scale; }
+
+        void update(TensorView<T,2> params,
+                    TensorView<const T,2> grads_view) override
         {
-            void* key = static_cast<void*>(&params);
+            // Los parámetros de una capa no se mueven de sitio: su dirección identifica el estado
+            void* key = static_cast<void*>(params.data());
 
             auto it = states_.find(key);
             if (it == states_.end()) {
-                auto state = std::make_unique<AdamState<T>>();
+                auto state = std::make_unique<AdamState<S>>();
                 state->initialize(params.shape());
                 states_[key] = std::move(state);
                 it = states_.find(key);
             }
 
-            AdamState<T>* state = it->second.get();
+            AdamState<S>* state = it->second.get();
 
             if (!state->is_initialized() ||
                 state->m_.shape() != params.shape() ||
@@ -82,36 +127,133 @@ namespace utec::neural_network {
 
             auto N = params.size();
 
-            if (grads.size() != N) {
+            if (grads_view.size() != N) {
                 throw std::runtime_error("Adam: Tamaño de gradientes no coincide con parámetros");
             }
 
+            T* param = params.data();
+            const T* grads = grads_view.data();
+            float* master = nullptr;
+            if constexpr (utec::algebra::is_half_v<T>) master = detail::master_weights(masters_, params);
+
             for (size_t i = 0; i < N; ++i) {
-                if (std::isnan(grads[i]) || std::isinf(grads[i])) {
+                const S grad = S(grads[i]) * grad_scale_;
+                if (std::isnan(grad) || std::isinf(grad)) {
                     throw std::runtime_error("Adam: Gradiente inválido detectado");
                 }
 
-                state->m_[i] = beta1_ * state->m_[i] + (T(1) - beta1_) * grads[i];
-                state->v_[i] = beta2_ * state->v_[i] + (T(1) - beta2_) * grads[i] * grads[i];
+                state->m_[i] = beta1_ * state->m_[i] + (S(1) - beta1_) * grad;
+                state->v_[i] = beta2_ * state->v_[i] + (S(1) - beta2_) * grad * grad;
 
-                T m_hat = state->m_[i] / (T(1) - std::pow(beta1_, T(state->t_)));
-                T v_hat = state->v_[i] / (T(1) - std::pow(beta2_, T(state->t_)));
+                S m_hat = state->m_[i] / (S(1) - std::pow(beta1_, S(state->t_)));
+                S v_hat = state->v_[i] / (S(1) - std::pow(beta2_, S(state->t_)));
 
-                T denominator = std::sqrt(v_hat) + eps_;
-                if (denominator <= T(0)) {
+                S denominator = std::sqrt(v_hat) + eps_;
+                if (denominator <= S(0)) {
                     throw std::runtime_error("Adam: Denominador inválido en actualización");
                 }
 
-                T update_value = lr_ * m_hat / denominator;
+                S update_value = lr_ * m_hat / denominator;
 
                 if (std::isnan(update_value) || std::isinf(update_value)) {
                     throw std::runtime_error("Adam: Actualización inválida calculada");
                 }
 
-                params[i] -= update_value;
+                if constexpr (utec::algebra::is_half_v<T>) {
+                    master[i] -= update_value;
+                    param[i] = master[i];
+                } else {
+                    param[i] -= update_value;
+                }
             }
         }
     };
+
+    // Escalado dinámico de la pérdida para entrenar con bf16 / fp16: el gradiente de la
+    // pérdida se multiplica por scale() para que los gradientes pequeños no se pierdan por
+    // underflow. Un paso con inf/NaN se descarta y reduce la escala; tras growth_interval
+    // pasos válidos seguidos la escala crece.
+    class LossScaler {
+        float scale_, growth_, backoff_;
+        size_t growth_interval_;
+        size_t good_steps_ = 0;
+        size_t skipped_steps_ = 0;
+
+    public:
+        explicit LossScaler(float initial_scale = 65536.0f,
+                            size_t growth_interval = 2000,
+                            float growth = 2.0f,
+                            float backoff = 0.5f)
+          : scale_{initial_scale}
+          , growth_{growth}
+          , backoff_{backoff}
+          , growth_interval_{growth_interval}
+        {}
+
+        float scale() const { return scale_; }
+        size_t skipped_steps() const { return skipped_steps_; }
+
+        // Registra si los gradientes del paso fueron finitos; devuelve si hay que aplicarlo
+        bool update(bool finite) {
+            if (!finite) {
+                scale_ = std::max(scale_ * backoff_, 1.0f);
+                good_steps_ = 0;
+                ++skipped_steps_;
+                return false;
+            }
+            if (++good_steps_ >= growth_interval_) {
+                scale_ *= growth_;
+                good_steps_ = 0;
+            }
+            return true;
+        }
+    };
+
+    // Solo lee los gradientes: detecta inf/NaN antes de tocar ningún parámetro
+    template<typename T>
+    struct GradientCheck final : IOptimizer<T> {
+        bool finite = true;
+
+        void update(TensorView<T,2>, TensorView<const T,2> grads) override {
+            const T* g = grads.data();
+            for (size_t i = 0, n = grads.size(); i < n && finite; ++i)
+                finite = std::isfinite(g[i]);
+        }
+    };
+
+    // Recoge, en el orden de update_params, las vistas de parámetros y gradientes de las
+    // capas. clear() conserva la memoria de los vectores
+    template<typename T>
+    struct ParameterViews final : IOptimizer<T> {
+        std::vector<TensorView<T,2>> params;
+        std::vector<TensorView<const T,2>> grads;
+
+        void clear() {
+            params.clear();
+            grads.clear();
+        }
+
+        void update(TensorView<T,2> p, TensorView<const T,2> g) override {
+            params.push_back(p);
+            grads.push_back(g);
+        }
+    };
+
+    // Entrega al optimizador interno otros gradientes (p. ej. los ya reducidos entre
+    // réplicas): el k-ésimo parámetro que llega recibe grads[k]
+    template<typename T>
+    struct ReplacedGradients final : IOptimizer<T> {
+        IOptimizer<T>& inner_;
+        const std::vector<Tensor<T,2>>& grads_;
+        size_t next_ = 0;
+
+        ReplacedGradients(IOptimizer<T>& inner, const std::vector<Tensor<T,2>>& grads)
+          : inner_{inner}, grads_{grads} {}
+
+        void update(TensorView<T,2> params, TensorView<const T,2>) override {
+            inner_.update(params, grads_.at(next_++));
+        }
+    };
 }
 
 #endif // PROG3_NN_FINAL_PROJECT_V2025_01_OPTIMIZER_H
@@ -0,0 +1,267 @@
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_QUANTIZATION_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_QUANTIZATION_H
+
+#include "neural_network/neural_network.h"
+#include "neural_network/nn_dense.h"
+#include "activations/nn_activation.h"
+#include "algebra/tensor.h"
+#include "algebra/gemm_int8.h"
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+// Cuantización post-entrenamiento a int8 para inferencia.
+// Pesos: int8 simétrico con una escala por neurona de salida (por canal).
+// Activaciones: uint8 asimétrico en [0, 127] con escala y punto cero calibrados
+// sobre una muestra de entrenamiento (min/max observados a la entrada de cada Dense).
+namespace utec::neural_network {
+
+    struct QuantParams {
+        float scale = 1.0f;
+        int32_t zero_point = 0;
+
+        // Rango [lo, hi] ampliado para contener el 0, que así se representa exacto
+        static QuantParams from_range(float lo, float hi) {
+            lo = std::min(lo, 0.0f);
+            hi = std::max(hi, 0.0f);
+            if (!(hi - lo > std::numeric_limits<float>::min())) return {};
+            const float scale = (hi - lo) / utec::algebra::int8_activation_max;
+            const auto zp = static_cast<int32_t>(std::nearbyint(-lo / scale));
+            return {scale, std::clamp(zp, int32_t(0), utec::algebra::int8_activation_max)};
+        }
+    };
+
+    enum class QuantizedActivation { None, ReLU, Sigmoid };
+
+    // Dense en int8 con la activación que la sigue. El epílogo del GEMM aplica
+    // escalas, bias y activación; si la siguiente capa también es cuantizada,
+    // recuantiza directamente a su entrada (con la ReLU fusionada como cota inferior).
+    class QuantizedDense {
+        size_t in_f_, out_f_;
+        utec::algebra::PackedInt8Matrix W_;
+        QuantParams input_;
+        QuantizedActivation act_;
+        std::vector<float> w_scale_;
+        std::vector<float> mult_, off_;          // salida en float
+        std::vector<float> req_mult_, req_off_;  // salida recuantizada
+        int32_t req_lo_ = 0;
+        bool requantize_ = false;
+
+    public:
+        // W (in x out) y b (1 x out) en float
+        QuantizedDense(const utec::algebra::Tensor<float,2>& W, const utec::algebra::Tensor<float,2>& b,
+                       QuantParams input, QuantizedActivation act)
+          : in_f_{W.shape()[0]}, out_f_{W.shape()[1]}, input_{input}, act_{act},
+            w_scale_(out_f_), mult_(out_f_), off_(out_f_)
+        {
+            if (b.size() != out_f_) {
+                throw std::invalid_argument("Bias size does not match the layer output");
+            }
+            std::vector<int8_t> q(in_f_ * out_f_);
+            for (size_t j = 0; j < out_f_; ++j) {
+                float max_abs = 0.0f;
+                for (size_t i = 0; i < in_f_; ++i) max_abs = std::max(max_abs, std::abs(W(i, j)));
+                w_scale_[j] = max_abs > 0.0f ? max_abs / utec::algebra::int8_weight_max : 1.0f;
+                for (size_t i = 0; i < in_f_; ++i)
+                    q[i * out_f_ + j] = static_cast<int8_t>(std::nearbyint(W(i, j) / w_scale_[j]));
+            }
+            W_ = utec::algebra::pack_int8(q.data(), in_f_, out_f_, out_f_);
+
+            // y_j = s_in * s_w[j] * (acc_j - zp_in * sum_k q_kj) + b_j = mult_j * acc_j + off_j
+            for (size_t j = 0; j < out_f_; ++j) {
+                mult_[j] = input_.scale * w_scale_[j];
+                off_[j] = b[j] - mult_[j] * static_cast<float>(input_.zero_point) * static_cast<float>(W_.col_sums[j]);
+            }
+        }
+
+        // Encadena con la capa siguiente: la salida se recuantiza con sus parámetros
+        void requantize_to(QuantParams next) {
+            if (act_ == QuantizedActivation::Sigmoid) {
+                throw std::logic_error("Sigmoid output must be dequantized before the next layer");
+            }
+            req_mult_.resize(out_f_);
+            req_off_.resize(out_f_);
+            const float inv = 1.0f / next.scale;
+            for (size_t j = 0; j < out_f_; ++j) {
+                req_mult_[j] = mult_[j] * inv;
+                req_off_[j] = off_[j] * inv + static_cast<float>(next.zero_point);
+            }
+            req_lo_ = act_ == QuantizedActivation::ReLU ? next.zero_point : 0;
+            requantize_ = true;
+        }
+
+        size_t input_size() const noexcept { return in_f_; }
+        size_t output_size() const noexcept { return out_f_; }
+        size_t input_stride() const noexcept { return W_.padded_k(); }
+        const QuantParams& input_params() const noexcept { return input_; }
+        QuantizedActivation activation() const noexcept { return act_; }
+        bool requantizes() const noexcept { return requantize_; }
+        const std::vector<float>& weight_scales() const noexcept { return w_scale_; }
+
+        // x: m filas uint8 con paso input_stride(); out: m filas uint8 con paso ldo
+        void forward_u8(size_t m, const uint8_t* x, uint8_t* out, size_t ldo) const {
+            utec::algebra::gemm_u8s8(m, x, input_stride(), W_, [&](size_t i, const int32_t* acc) {
+                utec::algebra::requantize_u7(acc, out_f_, req_mult_.data(), req_off_.data(), req_lo_, out + i * ldo);
+            });
+        }
+
+        // Igual, pero la salida queda en float (m x output_size()) con la activación aplicada
+        void forward_float(size_t m, const uint8_t* x, float* out) const {
+            const bool relu = act_ == QuantizedActivation::ReLU;
+            utec::algebra::gemm_u8s8(m, x, input_stride(), W_, [&](size_t i, const int32_t* acc) {
+                float* row = out + i * out_f_;
+                utec::algebra::dequantize_i32(acc, out_f_, mult_.data(), off_.data(), relu, row);
+                if (act_ == QuantizedActivation::Sigmoid)
+                    for (size_t j = 0; j < out_f_; ++j)
+                        row[j] = 1.0f / (1.0f + std::exp(-std::clamp(row[j], -500.0f, 500.0f)));
+            });
+        }
+    };
+
+    // Red de inferencia int8 producida por quantize_int8. predict es const y no
+    // comparte estado entre llamadas.
+    template<typename T>
+    class QuantizedNetwork {
+        std::vector<QuantizedDense> stages_;
+
+    public:
+        // Filas procesadas por bloque: las activaciones intermedias caben en L2
+        static constexpr size_t block_rows = 256;
+
+        explicit QuantizedNetwork(std::vector<QuantizedDense> stages) : stages_(std::move(stages)) {
+            if (stages_.empty()) {
+                throw std::invalid_argument("Quantized network needs at least one Dense layer");
+            }
+        }
+
+        size_t num_stages() const noexcept { return stages_.size(); }
+        const QuantizedDense& stage(size_t i) const { return stages_.at(i); }
+        size_t input_size() const noexcept { return stages_.front().input_size(); }
+        size_t output_size() const noexcept { return stages_.back().output_size(); }
+
+        utec::algebra::Tensor<T,2> predict(const utec::algebra::Tensor<T,2>& X) const {
+            if (X.shape()[1] != input_size()) {
+                throw std::invalid_argument("Input width does not match the quantized network");
+            }
+            const size_t num_samples = X.shape()[0];
+            utec::algebra::Tensor<T,2> results(num_samples, output_size());
+
+            size_t max_stride = 0, max_width = 0;
+            for (const auto& s : stages_) {
+                max_stride = std::max(max_stride, s.input_stride());
+                max_width = std::max(max_width, std::max(s.input_size(), s.output_size()));
+            }
+            const size_t rows_max = std::min(block_rows, num_samples);
+            std::vector<uint8_t> qa(rows_max * max_stride, 0), qb(rows_max * max_stride, 0);
+            std::vector<float> f(rows_max * max_width);
+
+            for (size_t r0 = 0; r0 < num_samples; r0 += block_rows) {
+                const size_t m = std::min(block_rows, num_samples - r0);
+                const T* xs = X.raw_data() + r0 * input_size();
+                const float* in_f = nullptr;
+                if constexpr (std::is_same_v<T, float>) {
+                    in_f = xs;
+                } else {
+                    utec::algebra::convert(xs, f.data(), m * input_size());
+                    in_f = f.data();
+                }
+
+                for (size_t s = 0; s < stages_.size(); ++s) {
+                    const QuantizedDense& st = stages_[s];
+                    // Entrada en float: la primera capa o la que sigue a una salida sin recuantizar
+                    if (in_f) {
+                        const QuantParams& p = st.input_params();
+                        for (size_t i = 0; i < m; ++i)
+                            utec::algebra::quantize_u7(in_f + i * st.input_size(), st.input_size(),
+                                                       1.0f / p.scale, p.zero_point, qa.data() + i * st.input_stride());
+                        in_f = nullptr;
+                    }
+                    if (st.requantizes()) {
+                        st.forward_u8(m, qa.data(), qb.data(), stages_[s + 1].input_stride());
+                        std::swap(qa, qb);
+                    } else {
+                        st.forward_float(m, qa.data(), f.data());
+                        in_f = f.data();
+                    }
+                }
+
+                T* out = results.raw_data() + r0 * output_size();
+                if constexpr (std::is_same_v<T, float>) {
+                    std::copy(in_f, in_f + m * output_size(), out);
+                } else {
+                    utec::algebra::convert(in_f, out, m * output_size());
+                }
+            }
+            return results;
+        }
+    };
+
+    namespace detail {
+
+        template<typename T>
+        void observe_range(const utec::algebra::Tensor<T,2>& x, float& lo, float& hi) {
+            lo = std::numeric_limits<float>::max();
+            hi = std::numeric_limits<float>::lowest();
+            const T* p = x.raw_data();
+            for (size_t i = 0; i < x.size(); ++i) {
+                lo = std::min(lo, static_cast<float>(p[i]));
+                hi = std::max(hi, static_cast<float>(p[i]));
+            }
+        }
+
+    }
+
+    // Calibra con las primeras max_samples filas de X (p. ej. del CSV de entrenamiento)
+    // y genera la red int8. Admite secuencias Dense [ReLU | Sigmoid] y FusedDense; cualquier
+    // otra capa lanza std::invalid_argument.
+    template<typename T>
+    QuantizedNetwork<T> quantize_int8(const NeuralNetwork<T>& net, const utec::algebra::Tensor<T,2>& X,
+                                      size_t max_samples = 512) {
+        if (X.shape()[0] == 0) {
+            throw std::invalid_argument("Calibration data is empty");
+        }
+        utec::algebra::Tensor<T,2> x(0, 0), next(0, 0);
+        utec::algebra::materialize(utec::algebra::rows(X, 0, std::min(max_samples, X.shape()[0])), x);
+
+        std::vector<QuantizedDense> stages;
+        for (size_t i = 0; i < net.num_layers(); ++i) {
+            const ILayer<T>& layer = net.layer(i);
+            const auto* dense = dynamic_cast<const DenseBase<T>*>(&layer);
+            if (!dense) {
+                throw std::invalid_argument("Only Dense layers followed by ReLU or Sigmoid can be quantized");
+            }
+            float lo, hi;
+            detail::observe_range(x, lo, hi);
+            const QuantParams input = QuantParams::from_range(lo, hi);
+
+            QuantizedActivation act = QuantizedActivation::None;
+            if (dynamic_cast<const FusedDense<T, ReLU>*>(&layer)) act = QuantizedActivation::ReLU;
+            else if (dynamic_cast<const FusedDense<T, Sigmoid>*>(&layer)) act = QuantizedActivation::Sigmoid;
+            dense->forward_inference(x, next);
+            std::swap(x, next);
+            if (act == QuantizedActivation::None && i + 1 < net.num_layers()) {
+                const ILayer<T>& following = net.layer(i + 1);
+                if (dynamic_cast<const ReLU<T>*>(&following)) act = QuantizedActivation::ReLU;
+                else if (dynamic_cast<const Sigmoid<T>*>(&following)) act = QuantizedActivation::Sigmoid;
+                if (act != QuantizedActivation::None) {
+                    following.forward_inference(x, next);
+                    std::swap(x, next);
+                    ++i;
+                }
+            }
+
+            if (!stages.empty() && stages.back().activation() != QuantizedActivation::Sigmoid) {
+                stages.back().requantize_to(input);
+            }
+            stages.emplace_back(utec::algebra::tensor_cast<float>(dense->weights()),
+                                utec::algebra::tensor_cast<float>(dense->bias()), input, act);
+        }
+        return QuantizedNetwork<T>(std::move(stages));
+    }
+
+}
+
+#endif // PROG3_NN_FINAL_PROJECT_V2025_01_QUANTIZATION_H
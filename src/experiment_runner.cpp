@@ -12,11 +12,34 @@ private:
     std::string data_path_test;
     std::vector<utec::training::TrainingResult> results;
     std::vector<utec::config::TrainingConfig> configs_used;
+    std::string precision = "fp32";
+
+    template<typename T>
+    utec::training::TrainingResult run_trainer_as(const utec::config::TrainingConfig& config) {
+        utec::training::Trainer<T> trainer(data_path_train, data_path_test);
+        trainer.run_training(config);
+        return trainer.get_last_result();
+    }
+
+    // Entrena con el tipo de elemento elegido: fp32, bf16 o fp16 (16 bits con acumulación en float)
+    utec::training::TrainingResult run_trainer(const utec::config::TrainingConfig& config) {
+        if (precision == "bf16") return run_trainer_as<utec::algebra::bf16>(config);
+        if (precision == "fp16") return run_trainer_as<utec::algebra::fp16>(config);
+        return run_trainer_as<float>(config);
+    }
 
 public:
     ExperimentRunner(const std::string& train_path, const std::string& test_path)
         : data_path_train(train_path), data_path_test(test_path) {}
 
+    const std::string& get_precision() const { return precision; }
+
+    bool set_precision(const std::string& value) {
+        if (value != "fp32" && value != "bf16" && value != "fp16") return false;
+        precision = value;
+        return true;
+    }
+
     void run_single_experiment(const std::string& config_input) {
         try {
             clear_results();
@@ -36,10 +59,7 @@ public:
             std::cout << "EJECUTANDO EXPERIMENTO: " << config_name << "\n";
             std::cout << "========================================\n\n";
 
-            utec::training::Trainer<float> trainer(data_path_train, data_path_test);
-            trainer.run_training(config);
-
-            auto result = trainer.get_last_result();
+            auto result = run_trainer(config);
             results.push_back(result);
             configs_used.push_back(config);
 
@@ -64,10 +84,7 @@ public:
                 std::cout << "EJECUTANDO EXPERIMENTO: " << config.name << "\n";
                 std::cout << "========================================\n\n";
 
-                utec::training::Trainer<float> trainer(data_path_train, data_path_test);
-                trainer.run_training(config);
-
-                auto result = trainer.get_last_result();
+                auto result = run_trainer(config);
                 results.push_back(result);
                 configs_used.push_back(config);
 
@@ -119,10 +136,7 @@ public:
                 std::cout << "EJECUTANDO EXPERIMENTO: " << valid_configs[i] << "\n";
                 std::cout << "========================================\n\n";
 
-                utec::training::Trainer<float> trainer(data_path_train, data_path_test);
-                trainer.run_training(config);
-
-                auto result = trainer.get_last_result();
+                auto result = run_trainer(config);
                 results.push_back(result);
                 configs_used.push_back(config);
 
@@ -192,6 +206,14 @@ private:
         std::cout << "Configuracion: " << result.config_name << "\n";
         std::cout << "Precision: " << std::fixed << std::setprecision(2) << result.accuracy << "%\n";
         std::cout << "Muestras correctas: " << result.correct_predictions << " / " << result.total_samples << "\n";
+        std::cout << "Precision int8: " << result.int8_accuracy << "% ("
+                  << std::setprecision(1) << result.int8_samples_per_sec / result.float_samples_per_sec
+                  << "x muestras/s frente a float)\n" << std::setprecision(2);
+        if (result.async_samples_per_sec > 0.0) {
+            std::cout << "Precision Hogwild: " << result.async_accuracy << "% ("
+                      << std::setprecision(1) << result.async_samples_per_sec / result.train_samples_per_sec
+                      << "x muestras/s de entrenamiento frente a sincrono)\n" << std::setprecision(2);
+        }
         std::cout << "Tiempo de carga: " << result.load_time_ms << " ms\n";
         std::cout << "Tiempo de entrenamiento: " << result.train_time_ms << " ms\n";
         std::cout << "Tiempo de evaluacion: " << result.eval_time_ms << " ms\n";
@@ -297,7 +319,7 @@ private:
             return;
         }
 
-        file << "Configuracion,Epocas,Learning_Rate,Precision,Correctas,Total,Tiempo_Carga,Tiempo_Entrenamiento,Tiempo_Evaluacion,Tiempo_Total\n";
+        file << "Configuracion,Epocas,Learning_Rate,Precision,Correctas,Total,Tiempo_Carga,Tiempo_Entrenamiento,Tiempo_Evaluacion,Tiempo_Total,Precision_Int8,Muestras_s_Entrenamiento,Precision_Hogwild,Muestras_s_Hogwild\n";
 
         for (size_t i = 0; i < results.size(); ++i) {
             const auto& result = results[i];
@@ -312,7 +334,11 @@ private:
                  << result.load_time_ms << ","
                  << result.train_time_ms << ","
                  << result.eval_time_ms << ","
-                 << result.total_time_ms << "\n";
+                 << result.total_time_ms << ","
+                 << std::fixed << std::setprecision(2) << result.int8_accuracy << ","
+                 << std::setprecision(0) << result.train_samples_per_sec << ","
+                 << std::setprecision(2) << result.async_accuracy << ","
+                 << std::setprecision(0) << result.async_samples_per_sec << "\n";
         }
 
         file.close();
@@ -350,7 +376,8 @@ int main() {
             std::cout << "3. Ejecutar todos los experimentos\n";
             std::cout << "4. Ejecutar experimentos seleccionados\n";
             std::cout << "5. Ver resultados actuales\n";
-            std::cout << "6. Salir\n";
+            std::cout << "6. Cambiar precision (actual: " << runner.get_precision() << ")\n";
+            std::cout << "7. Salir\n";
             std::cout << "Opcion: ";
 
             int option;
@@ -423,7 +450,19 @@ int main() {
                     runner.show_current_results();
                     break;
 
-                case 6:
+                case 6: {
+                    std::cout << "Precision (fp32, bf16, fp16): ";
+                    std::string value;
+                    std::getline(std::cin, value);
+                    if (runner.set_precision(value)) {
+                        std::cout << "Precision cambiada a " << value << "\n";
+                    } else {
+                        std::cout << "Error: Precision no valida.\n";
+                    }
+                    break;
+                }
+
+                case 7:
                     std::cout << "Hasta luego!\n";
                     return 0;
 
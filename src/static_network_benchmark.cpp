@@ -0,0 +1,106 @@
+#include "neural_network/neural_network.h"
+#include "neural_network/static_network.h"
+#include "loss_functions/nn_loss.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include <memory>
+#include <algorithm>
+
+// Compara NeuralNetwork (capas en vector<unique_ptr<ILayer>>, llamadas virtuales) con
+// StaticNetwork (capas en std::tuple, llamadas directas) con las mismas capas y pesos.
+// Con redes pequeñas y lotes cortos pesa más el coste por capa que el GEMM.
+
+using utec::algebra::Tensor;
+using utec::neural_network::Dense;
+using utec::neural_network::FusedDense;
+using utec::neural_network::ReLU;
+using utec::neural_network::Sigmoid;
+using utec::neural_network::MSELoss;
+using utec::neural_network::NeuralNetwork;
+using utec::neural_network::StaticNetwork;
+
+namespace {
+
+    constexpr size_t kSamples = 4096;
+    constexpr size_t kInputs = 64, kHidden = 32, kOutputs = 10;
+    constexpr size_t kEpochs = 5;
+    constexpr int kRepeats = 5;
+
+    void init_w(Tensor<float, 2>& w) {
+        for (size_t i = 0; i < w.size(); ++i) w[i] = 0.01f * static_cast<float>(i % 23) - 0.11f;
+    }
+
+    void init_b(Tensor<float, 2>& b) { b.fill(0.01f); }
+
+    // Mejor de kRepeats, en microsegundos
+    template<typename F>
+    double best_us(F&& f) {
+        double best = 1e300;
+        for (int r = 0; r < kRepeats; ++r) {
+            auto start = std::chrono::high_resolution_clock::now();
+            f();
+            auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+        }
+        return best;
+    }
+
+    // NeuralNetwork::train siempre imprime cada época: se descarta para no medir la consola
+    template<typename F>
+    double best_us_quiet(F&& f) {
+        std::ostringstream sink;
+        auto* previous = std::cout.rdbuf(sink.rdbuf());
+        double us = best_us(f);
+        std::cout.rdbuf(previous);
+        return us;
+    }
+
+    void print_row(const std::string& name, size_t batch, double dynamic_us, double static_us, size_t steps) {
+        std::cout << std::left << std::setw(10) << name << std::right << std::setw(7) << batch
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(19) << dynamic_us / static_cast<double>(steps)
+                  << std::setw(19) << static_us / static_cast<double>(steps)
+                  << std::setw(10) << dynamic_us / static_us << "x\n";
+    }
+
+}
+
+int main() {
+    Tensor<float, 2> X(kSamples, kInputs), Y(kSamples, kOutputs);
+    for (size_t i = 0; i < X.size(); ++i) X[i] = 0.1f * static_cast<float>((i * 5) % 13) - 0.6f;
+    for (size_t i = 0; i < kSamples; ++i) Y(i, (i * 7) % kOutputs) = 1.0f;
+
+    std::cout << "=== NeuralNetwork vs StaticNetwork (" << kInputs << "-" << kHidden << "-" << kOutputs
+              << ", " << kSamples << " muestras, " << utec::algebra::num_threads() << " hilos) ===\n";
+    std::cout << std::left << std::setw(10) << "Fase" << std::right << std::setw(7) << "Lote"
+              << std::setw(19) << "Dinamica us/lote" << std::setw(19) << "Estatica us/lote"
+              << std::setw(11) << "Mejora" << "\n";
+
+    for (size_t batch : {1, 8, 32, 128}) {
+        // Misma topología y pesos: Dense + ReLU se fusiona también en la red dinámica
+        NeuralNetwork<float> dynamic_net;
+        dynamic_net.add_layer(std::make_unique<Dense<float>>(kInputs, kHidden, init_w, init_b));
+        dynamic_net.add_layer(std::make_unique<ReLU<float>>());
+        dynamic_net.add_layer(std::make_unique<Dense<float, kHidden, kOutputs>>(init_w, init_b));
+        dynamic_net.add_layer(std::make_unique<Sigmoid<float>>());
+
+        StaticNetwork<float, FusedDense<float, ReLU>, Dense<float, kHidden, kOutputs>, Sigmoid<float>> static_net(
+            FusedDense<float, ReLU>(kInputs, kHidden, init_w, init_b),
+            Dense<float, kHidden, kOutputs>(init_w, init_b), Sigmoid<float>());
+
+        const size_t steps = kEpochs * ((kSamples + batch - 1) / batch);
+        double dynamic_train = best_us_quiet([&] { dynamic_net.train<MSELoss>(X, Y, kEpochs, batch, 0, 0.01f); });
+        double static_train = best_us([&] { static_net.train<MSELoss>(X, Y, kEpochs, batch, 0, 0.01f); });
+        print_row("train", batch, dynamic_train, static_train, steps);
+
+        const size_t batches = (kSamples + batch - 1) / batch;
+        double dynamic_predict = best_us([&] { dynamic_net.predict(X, batch); });
+        double static_predict = best_us([&] { static_net.predict(X, batch); });
+        print_row("predict", batch, dynamic_predict, static_predict, batches);
+    }
+
+    return 0;
+}
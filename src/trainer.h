@@ -4,11 +4,14 @@
 #include "../include/utec/neural_network/neural_network.h"
 #include "../include/utec/factories/nn_factory.h"
 #include "../include/utec/data_processing/data_loader.h"
+#include "../include/utec/algebra/reductions.h"
+#include "../include/utec/quantization/nn_quantization.h"
 #include "config.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
 #include <fstream>
+#include <type_traits>
 
 namespace utec::training {
     struct TrainingResult {
@@ -20,8 +23,16 @@ namespace utec::training {
         long long total_time_ms;
         size_t correct_predictions;
         size_t total_samples;
+        float int8_accuracy;
+        double float_samples_per_sec;
+        double int8_samples_per_sec;
+        double train_samples_per_sec;
+        float async_accuracy;
+        double async_samples_per_sec;
         TrainingResult() : accuracy(0.0f), load_time_ms(0), train_time_ms(0),
-                          eval_time_ms(0), total_time_ms(0), correct_predictions(0), total_samples(0) {}
+                          eval_time_ms(0), total_time_ms(0), correct_predictions(0), total_samples(0),
+                          int8_accuracy(0.0f), float_samples_per_sec(0.0), int8_samples_per_sec(0.0),
+                          train_samples_per_sec(0.0), async_accuracy(0.0f), async_samples_per_sec(0.0) {}
     };
     template<typename T>
     class Trainer {
@@ -34,6 +45,27 @@ namespace utec::training {
         void train_with_config(const utec::config::TrainingConfig& config,
                               const utec::algebra::Tensor<T,2>& X_train,
                               const utec::algebra::Tensor<T,2>& Y_train);
+        static void add_layers(utec::neural_network::NeuralNetwork<T>& net) {
+            using namespace utec::neural_network;
+            net.add_layer(LayerFactory<T>::create_dense(64, 128));
+            net.add_layer(LayerFactory<T>::create_relu());
+            net.add_layer(LayerFactory<T>::create_dense(128, 64));
+            net.add_layer(LayerFactory<T>::create_relu());
+            net.add_layer(LayerFactory<T>::create_dense(64, 10));
+            net.add_layer(LayerFactory<T>::create_sigmoid());
+        }
+        static size_t count_correct(const utec::algebra::Tensor<T,2>& predictions,
+                                    const utec::algebra::Tensor<T,2>& Y) {
+            auto predicted = utec::algebra::argmax(predictions, 1);
+            auto actual = utec::algebra::argmax(Y, 1);
+            size_t correct = 0;
+            for (size_t i = 0; i < Y.shape()[0]; ++i) {
+                if (predicted[i] == actual[i]) {
+                    ++correct;
+                }
+            }
+            return correct;
+        }
     public:
         Trainer(const std::string& train_path, const std::string& test_path)
             : data_path_train(train_path), data_path_test(test_path) {
@@ -48,12 +80,12 @@ namespace utec::training {
             std::cout << "  - Capa oculta 2: 64 neuronas + ReLU\n";
             std::cout << "  - Capa de salida: 10 neuronas + Sigmoid\n\n";
 
-            nn.add_layer(LayerFactory<T>::create_dense(64, 128));
-            nn.add_layer(LayerFactory<T>::create_relu());
-            nn.add_layer(LayerFactory<T>::create_dense(128, 64));
-            nn.add_layer(LayerFactory<T>::create_relu());
-            nn.add_layer(LayerFactory<T>::create_dense(64, 10));
-            nn.add_layer(LayerFactory<T>::create_sigmoid());
+            add_layers(nn);
+            // fp16 tiene poco rango: los gradientes pequeños necesitan escalado de la pérdida
+            if constexpr (std::is_same_v<T, utec::algebra::fp16>) {
+                nn.enable_loss_scaling();
+                std::cout << "Escalado dinamico de la perdida activado (fp16)\n";
+            }
             std::cout << "Red neuronal configurada exitosamente\n\n";
         }
         std::pair<utec::algebra::Tensor<T,2>, utec::algebra::Tensor<T,2>> load_data(bool is_train = true) {
@@ -79,30 +111,8 @@ namespace utec::training {
             std::cout << "=== EVALUANDO MODELO ===\n";
             auto start = std::chrono::high_resolution_clock::now();
             auto predictions = nn.predict(X_test);
-            size_t correct = 0;
             size_t total_samples = X_test.shape()[0];
-
-            for (size_t i = 0; i < total_samples; ++i) {
-                size_t predicted = 0;
-                T max_pred = predictions(i, 0);
-                for (size_t j = 1; j < predictions.shape()[1]; ++j) {
-                    if (predictions(i, j) > max_pred) {
-                        max_pred = predictions(i, j);
-                        predicted = j;
-                    }
-                }
-                size_t actual = 0;
-                T max_actual = Y_test(i, 0);
-                for (size_t j = 1; j < Y_test.shape()[1]; ++j) {
-                    if (Y_test(i, j) > max_actual) {
-                        max_actual = Y_test(i, j);
-                        actual = j;
-                    }
-                }
-                if (predicted == actual) {
-                    ++correct;
-                }
-            }
+            size_t correct = count_correct(predictions, Y_test);
             auto end = std::chrono::high_resolution_clock::now();
             auto eval_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
@@ -115,6 +125,78 @@ namespace utec::training {
             std::cout << "Precision: " << std::fixed << std::setprecision(2) << current_result.accuracy << "%\n";
             std::cout << "Muestras correctas: " << correct << " / " << total_samples << "\n\n";
         }
+        // Cuantiza la red entrenada a int8 (calibrando con el CSV de entrenamiento)
+        // y la compara con el modelo en punto flotante sobre el conjunto de prueba
+        void evaluate_int8(const utec::algebra::Tensor<T,2>& X_train,
+                           const utec::algebra::Tensor<T,2>& X_test,
+                           const utec::algebra::Tensor<T,2>& Y_test) {
+            using namespace utec::neural_network;
+            constexpr size_t calibration_samples = 512;
+            constexpr size_t repetitions = 20;
+            std::cout << "=== INFERENCIA INT8 (CUANTIZACION POST-ENTRENAMIENTO) ===\n";
+            auto quantized = quantize_int8(nn, X_train, calibration_samples);
+
+            auto predictions = nn.predict(X_test);
+            auto predictions_int8 = quantized.predict(X_test);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t r = 0; r < repetitions; ++r) predictions = nn.predict(X_test);
+            auto mid = std::chrono::high_resolution_clock::now();
+            for (size_t r = 0; r < repetitions; ++r) predictions_int8 = quantized.predict(X_test);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            auto predicted = utec::algebra::argmax(predictions, 1);
+            auto predicted_int8 = utec::algebra::argmax(predictions_int8, 1);
+            auto actual = utec::algebra::argmax(Y_test, 1);
+            const size_t total_samples = X_test.shape()[0];
+            size_t correct = 0, agree = 0;
+            for (size_t i = 0; i < total_samples; ++i) {
+                if (predicted_int8[i] == actual[i]) ++correct;
+                if (predicted_int8[i] == predicted[i]) ++agree;
+            }
+
+            const double samples = static_cast<double>(total_samples * repetitions);
+            current_result.int8_accuracy = (float)correct / total_samples * 100.0f;
+            current_result.float_samples_per_sec = samples / std::chrono::duration<double>(mid - start).count();
+            current_result.int8_samples_per_sec = samples / std::chrono::duration<double>(end - mid).count();
+            std::cout << "Calibracion: " << std::min(calibration_samples, X_train.shape()[0])
+                      << " muestras de entrenamiento, " << quantized.num_stages() << " capas Dense en int8\n";
+            std::cout << "Precision float: " << std::fixed << std::setprecision(2) << current_result.accuracy
+                      << "% - int8: " << current_result.int8_accuracy << "%\n";
+            std::cout << "Predicciones iguales a float: " << agree << " / " << total_samples << "\n";
+            std::cout << "Rendimiento float: " << std::setprecision(0) << current_result.float_samples_per_sec
+                      << " muestras/s - int8: " << current_result.int8_samples_per_sec << " muestras/s ("
+                      << std::setprecision(2) << current_result.int8_samples_per_sec / current_result.float_samples_per_sec
+                      << "x)\n\n";
+        }
+        // Entrena una red nueva con SGD asíncrono sin bloqueos (Hogwild) y la misma
+        // configuración, y la compara con el entrenamiento síncrono
+        template<template<typename...> class LossFunction>
+        void evaluate_async(const utec::config::TrainingConfig& config,
+                            const utec::algebra::Tensor<T,2>& X_train,
+                            const utec::algebra::Tensor<T,2>& Y_train,
+                            const utec::algebra::Tensor<T,2>& X_test,
+                            const utec::algebra::Tensor<T,2>& Y_test) {
+            if constexpr (std::is_floating_point_v<T>) {
+                std::cout << "=== ENTRENAMIENTO ASINCRONO (HOGWILD) ===\n";
+                std::cout << "Hilos: " << utec::algebra::num_threads() << "\n";
+                utec::neural_network::NeuralNetwork<T> async_nn;
+                add_layers(async_nn);
+                auto start = std::chrono::high_resolution_clock::now();
+                async_nn.template train_async<LossFunction>(X_train, Y_train,
+                    config.epochs, config.batch_size, 1, config.learning_rate);
+                auto end = std::chrono::high_resolution_clock::now();
+
+                const double seconds = std::chrono::duration<double>(end - start).count();
+                current_result.async_samples_per_sec = static_cast<double>(X_train.shape()[0] * config.epochs) / seconds;
+                current_result.async_accuracy =
+                    (float)count_correct(async_nn.predict(X_test), Y_test) / X_test.shape()[0] * 100.0f;
+                std::cout << "Precision sincrono: " << std::fixed << std::setprecision(2) << current_result.accuracy
+                          << "% - Hogwild: " << current_result.async_accuracy << "%\n";
+                std::cout << "Entrenamiento sincrono: " << std::setprecision(0) << current_result.train_samples_per_sec
+                          << " muestras/s - Hogwild: " << current_result.async_samples_per_sec << " muestras/s\n\n"
+                          << std::setprecision(2);
+            }
+        }
         void run_training(const utec::config::TrainingConfig& config) {
             using namespace utec::neural_network;
             std::cout << "=== INICIANDO EXPERIMENTO: " << config.name << " ===\n\n";
@@ -135,6 +217,15 @@ namespace utec::training {
             }
 
             evaluate(X_test, Y_test);
+            evaluate_int8(X_train, X_test, Y_test);
+            // Hogwild solo aplica SGD: se compara con las configuraciones SGD en float
+            if (config.optimizer == "SGD") {
+                if (config.loss_function == "BCELoss") {
+                    this->template evaluate_async<BCELoss>(config, X_train, Y_train, X_test, Y_test);
+                } else {
+                    this->template evaluate_async<MSELoss>(config, X_train, Y_train, X_test, Y_test);
+                }
+            }
         }
         TrainingResult get_last_result() const {
             return current_result;
@@ -163,8 +254,14 @@ namespace utec::training {
             config.epochs, config.batch_size, 0, config.learning_rate);
         auto end = std::chrono::high_resolution_clock::now();
         current_result.train_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        current_result.train_samples_per_sec = static_cast<double>(X_train.shape()[0] * config.epochs)
+            / std::chrono::duration<double>(end - start).count();
         current_result.config_name = config.name;
         std::cout << "Entrenamiento completado en " << current_result.train_time_ms << " ms\n";
+        if (const auto* scaler = nn.loss_scaler()) {
+            std::cout << "Pasos descartados por overflow: " << scaler->skipped_steps()
+                      << " (escala final: " << scaler->scale() << ")\n";
+        }
         std::cout << "Tiempo promedio por epoca: " << current_result.train_time_ms / config.epochs << " ms\n\n";
     }
 }
@@ -0,0 +1,10 @@
+// =============================================
+// tests/main_test_tensor_algebra.cpp
+// =============================================
+#include "test_tensor_algebra.h"
+
+int main() {
+    tests::TestTensorAlgebra test;
+    test.run_tests();
+    return (test.get_tests_passed() == test.get_tests_total()) ? 0 : 1;
+}
@@ -0,0 +1,1419 @@
+#pragma once
+
+#include "../test_base.h"
+#include "../../include/utec/algebra/tensor.h"
+#include "../../include/utec/algebra/gemm.h"
+#include "../../include/utec/algebra/gemm_int8.h"
+#include "../../include/utec/algebra/sparse.h"
+#include "../../include/utec/algebra/half.h"
+#include "../../include/utec/algebra/tensor_view.h"
+#include "../../include/utec/algebra/thread_pool.h"
+#include "../../include/utec/algebra/static_tensor.h"
+#include "../../include/utec/algebra/reductions.h"
+#include "../../include/utec/neural_network/nn_dense.h"
+#include "../../include/utec/neural_network/neural_network.h"
+#include "../../include/utec/optimizers/nn_optimizer.h"
+#include <vector>
+#include <random>
+
+using utec::algebra::Tensor;
+using utec::algebra::GemmIsa;
+
+namespace tests {
+
+class TestTensorAlgebra : public TestBase {
+public:
+    void run_tests() override {
+        test_gemm_against_reference();
+        test_gemm_accumulate();
+        test_matrix_product_tensor();
+        test_transposed_products();
+        test_tensor_views();
+        test_move_and_compound_ops();
+        test_lazy_expressions();
+        test_broadcast_paths();
+        test_storage_policies();
+        test_bounds_policy();
+        test_thread_pool_and_parallel_gemm();
+        test_blocked_transpose();
+        test_static_tensor();
+        test_small_buffer_storage();
+        test_axis_reductions();
+        test_batched_matrix_product();
+        test_half_precision();
+        test_int8_gemm();
+        test_sparse_matrix_product();
+        test_fused_dense();
+        print_summary("TESTS DE ALGEBRA TENSORIAL");
+    }
+
+private:
+    template<typename T>
+    static std::vector<T> random_matrix(size_t rows, size_t cols, std::mt19937& gen) {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<T> m(rows * cols);
+        for (auto& v : m) v = static_cast<T>(dist(gen));
+        return m;
+    }
+
+    template<typename T>
+    static std::vector<T> reference_product(const std::vector<T>& a, const std::vector<T>& b,
+                                            size_t m, size_t n, size_t k) {
+        std::vector<T> c(m * n, T(0));
+        for (size_t i = 0; i < m; ++i)
+            for (size_t p = 0; p < k; ++p)
+                for (size_t j = 0; j < n; ++j)
+                    c[i * n + j] += a[i * k + p] * b[p * n + j];
+        return c;
+    }
+
+    template<typename T>
+    bool check_gemm(size_t m, size_t n, size_t k, std::mt19937& gen) {
+        auto a = random_matrix<T>(m, k, gen);
+        auto b = random_matrix<T>(k, n, gen);
+        auto expected = reference_product(a, b, m, n, k);
+        std::vector<T> c(m * n, T(-7));
+        utec::algebra::gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n);
+        for (size_t i = 0; i < m * n; ++i) {
+            if (std::abs(static_cast<double>(c[i] - expected[i])) > 1e-3 * (1.0 + k / 64.0)) {
+                std::cout << "  Diferencia en [" << m << "x" << n << "x" << k << "] indice " << i
+                          << ": " << c[i] << " vs " << expected[i] << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void test_gemm_against_reference() {
+        print_test_header("TEST GEMM CONTRA PRODUCTO DE REFERENCIA");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(42);
+            const size_t shapes[][3] = {
+                {1, 1, 1}, {5, 128, 64}, {7, 13, 300}, {64, 10, 64},
+                {97, 33, 17}, {130, 70, 257}, {200, 2100, 9}
+            };
+            const GemmIsa original = utec::algebra::gemm_isa();
+
+            for (GemmIsa isa : {GemmIsa::Scalar, GemmIsa::AVX2, GemmIsa::AVX512}) {
+                if (!utec::algebra::set_gemm_isa(isa)) {
+                    std::cout << "ISA " << utec::algebra::gemm_isa_name(isa) << " no disponible, se omite\n";
+                    continue;
+                }
+                for (const auto& s : shapes) {
+                    all_passed = check_gemm<float>(s[0], s[1], s[2], gen) && all_passed;
+                    all_passed = check_gemm<double>(s[0], s[1], s[2], gen) && all_passed;
+                }
+                std::cout << "Kernel " << utec::algebra::gemm_isa_name(isa) << " verificado\n";
+            }
+            utec::algebra::set_gemm_isa(original);
+            assert(all_passed);
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de GEMM: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("GEMM contra producto de referencia", all_passed);
+    }
+
+    void test_gemm_accumulate() {
+        print_test_header("TEST GEMM CON ACUMULACION");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(7);
+            const size_t m = 37, n = 41, k = 290;
+            auto a = random_matrix<float>(m, k, gen);
+            auto b = random_matrix<float>(k, n, gen);
+            auto expected = reference_product(a, b, m, n, k);
+
+            std::vector<float> c(m * n, 1.0f);
+            utec::algebra::gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n, true);
+            for (size_t i = 0; i < m * n; ++i)
+                all_passed = all_passed && is_close(c[i], expected[i] + 1.0f, 1e-3f);
+            assert(all_passed);
+            std::cout << "C += A * B acumula sobre el contenido previo de C\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de acumulacion: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("GEMM con acumulacion", all_passed);
+    }
+
+    void test_matrix_product_tensor() {
+        print_test_header("TEST MATRIX_PRODUCT SOBRE TENSORES");
+
+        bool all_passed = true;
+
+        try {
+            Tensor<float, 2> a(2, 3);
+            a = {1.0f, 2.0f, 3.0f,
+                 4.0f, 5.0f, 6.0f};
+            Tensor<float, 2> b(3, 2);
+            b = {7.0f, 8.0f,
+                 9.0f, 10.0f,
+                 11.0f, 12.0f};
+
+            auto c = utec::algebra::matrix_product(a, b);
+            assert(c.shape()[0] == 2 && c.shape()[1] == 2);
+            assert(is_close(c(0, 0), 58.0f));
+            assert(is_close(c(0, 1), 64.0f));
+            assert(is_close(c(1, 0), 139.0f));
+            assert(is_close(c(1, 1), 154.0f));
+            std::cout << "Producto [2x3] * [3x2] correcto\n";
+
+            bool threw = false;
+            try {
+                utec::algebra::matrix_product(a, a);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+            std::cout << "Dimensiones incompatibles lanzan invalid_argument\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de matrix_product: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("matrix_product sobre tensores", all_passed);
+    }
+
+    void test_transposed_products() {
+        print_test_header("TEST PRODUCTOS TRANSPUESTOS (TN / NT)");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(3);
+            const size_t shapes[][3] = {{3, 4, 2}, {64, 128, 5}, {33, 70, 129}, {128, 64, 100}};
+            const GemmIsa original = utec::algebra::gemm_isa();
+
+            for (GemmIsa isa : {GemmIsa::Scalar, GemmIsa::AVX2, GemmIsa::AVX512}) {
+                if (!utec::algebra::set_gemm_isa(isa)) continue;
+                for (const auto& s : shapes) {
+                    const size_t m = s[0], n = s[1], k = s[2];
+                    Tensor<float, 2> x(k, m), g(k, n), w(m, n);
+                    for (size_t i = 0; i < x.size(); ++i) x[i] = std::uniform_real_distribution<float>(-1, 1)(gen);
+                    for (size_t i = 0; i < g.size(); ++i) g[i] = std::uniform_real_distribution<float>(-1, 1)(gen);
+                    for (size_t i = 0; i < w.size(); ++i) w[i] = std::uniform_real_distribution<float>(-1, 1)(gen);
+
+                    auto tn = utec::algebra::matrix_product_tn(x, g);
+                    auto tn_ref = utec::algebra::matrix_product(utec::algebra::transpose_2d(x), g);
+                    auto nt = utec::algebra::matrix_product_nt(g, w);
+                    auto nt_ref = utec::algebra::matrix_product(g, utec::algebra::transpose_2d(w));
+
+                    assert(tn.shape() == tn_ref.shape() && nt.shape() == nt_ref.shape());
+                    for (size_t i = 0; i < tn.size(); ++i)
+                        all_passed = all_passed && is_close(tn[i], tn_ref[i], 1e-3f);
+                    for (size_t i = 0; i < nt.size(); ++i)
+                        all_passed = all_passed && is_close(nt[i], nt_ref[i], 1e-3f);
+                }
+                std::cout << "A^T*B y A*B^T coinciden con la transpuesta explicita ("
+                          << utec::algebra::gemm_isa_name(isa) << ")\n";
+            }
+            utec::algebra::set_gemm_isa(original);
+            assert(all_passed);
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de productos transpuestos: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Productos transpuestos sin copia", all_passed);
+    }
+
+    void test_tensor_views() {
+        print_test_header("TEST VISTAS DE TENSOR (TensorView)");
+
+        bool all_passed = true;
+
+        try {
+            Tensor<float, 2> data(6, 3);
+            for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<float>(i);
+
+            auto slice = utec::algebra::rows(data, 2, 5);
+            assert(slice.shape()[0] == 3 && slice.shape()[1] == 3);
+            assert(slice.data() == &data(2, 0));
+            assert(is_close(slice(0, 0), 6.0f) && is_close(slice(2, 2), 14.0f));
+            std::cout << "rows(2, 5) apunta a los datos originales sin copia\n";
+
+            std::vector<size_t> idx = {4, 0, 5};
+            auto picked = utec::algebra::gather(data, idx);
+            assert(is_close(picked(0, 1), 13.0f) && is_close(picked(1, 1), 1.0f) && is_close(picked(2, 0), 15.0f));
+            auto picked_tail = picked.rows(1, 3);
+            assert(is_close(picked_tail(0, 2), 2.0f) && is_close(picked_tail(1, 2), 17.0f));
+            std::cout << "gather respeta el orden de los indices y admite sub-rangos\n";
+
+            auto dense = utec::algebra::materialize(picked);
+            Tensor<float, 2> w(3, 4);
+            for (size_t i = 0; i < w.size(); ++i) w[i] = 0.25f * static_cast<float>(i) - 1.0f;
+
+            auto from_view = utec::algebra::matrix_product(picked, w);
+            auto from_copy = utec::algebra::matrix_product(dense, w);
+            auto tn_view = utec::algebra::matrix_product_tn(picked, from_view);
+            auto tn_copy = utec::algebra::matrix_product_tn(dense, from_copy);
+            for (size_t i = 0; i < from_view.size(); ++i)
+                all_passed = all_passed && is_close(from_view[i], from_copy[i]);
+            for (size_t i = 0; i < tn_view.size(); ++i)
+                all_passed = all_passed && is_close(tn_view[i], tn_copy[i], 1e-3f);
+            assert(all_passed);
+            std::cout << "matrix_product y matrix_product_tn aceptan vistas con gather\n";
+
+            auto layer = utec::neural_network::Dense<float>(3, 2,
+                [](Tensor<float, 2>& m) { for (size_t i = 0; i < m.size(); ++i) m[i] = 0.1f * static_cast<float>(i + 1); },
+                [](Tensor<float, 2>& b) { b.fill(0.5f); });
+            auto out_view = layer.forward(slice);
+            auto out_copy = layer.forward(utec::algebra::materialize(slice));
+            for (size_t i = 0; i < out_view.size(); ++i)
+                all_passed = all_passed && is_close(out_view[i], out_copy[i]);
+            assert(all_passed);
+            std::cout << "Dense::forward produce lo mismo con una vista que con una copia\n";
+
+            bool threw = false;
+            try {
+                utec::algebra::rows(data, 4, 7);
+            } catch (const std::out_of_range&) {
+                threw = true;
+            }
+            assert(threw);
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de vistas: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Vistas de tensor sin copia", all_passed);
+    }
+
+    void test_move_and_compound_ops() {
+        print_test_header("TEST MOVIMIENTO Y OPERADORES COMPUESTOS");
+
+        bool all_passed = true;
+
+        try {
+            Tensor<float, 2> a(64, 64);
+            a.fill(1.0f);
+            const float* buffer = a.raw_data();
+            Tensor<float, 2> b = std::move(a);
+            assert(b.raw_data() == buffer);
+            Tensor<float, 2> c(1, 1);
+            c = std::move(b);
+            assert(c.raw_data() == buffer);
+            std::cout << "Mover un tensor transfiere su buffer sin copiarlo\n";
+
+            Tensor<float, 2> x(2, 3);
+            x = {1.0f, 2.0f, 3.0f,
+                 4.0f, 5.0f, 6.0f};
+            Tensor<float, 2> row(1, 3);
+            row = {10.0f, 20.0f, 30.0f};
+            x += row;
+            assert(is_close(x(0, 0), 11.0f) && is_close(x(1, 2), 36.0f));
+            x -= x;
+            assert(is_close(x(1, 1), 0.0f));
+            x += 2.0f;
+            x *= 3.0f;
+            x /= 2.0f;
+            x -= 1.0f;
+            assert(is_close(x(0, 2), 2.0f));
+            x *= row;
+            assert(is_close(x(1, 1), 40.0f));
+            std::cout << "+=, -=, *=, /= funcionan con tensores, escalares y broadcasting\n";
+
+            bool threw = false;
+            try {
+                Tensor<float, 2> wide(2, 5);
+                x += wide;
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+
+            Tensor<float, 2> buf(8, 8);
+            const float* before = buf.raw_data();
+            buf.reshape({2, 3});
+            assert(buf.size() == 6);
+            buf.reshape({4, 16});
+            assert(buf.size() == 64 && buf.raw_data() == before);
+            std::cout << "reshape reutiliza la capacidad ya reservada\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de movimiento: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Movimiento y operadores compuestos", all_passed);
+    }
+
+    void test_lazy_expressions() {
+        print_test_header("TEST EXPRESIONES PEREZOSAS");
+
+        bool all_passed = true;
+
+        try {
+            Tensor<float, 2> a(2, 3), b(2, 3), c(2, 3);
+            a = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+            b = {0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f};
+            c = {1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f};
+
+            auto expr = a * 2.0f + b - c;
+            static_assert(!std::is_same_v<decltype(expr), Tensor<float, 2>>);
+            Tensor<float, 2> r = expr;
+            for (size_t i = 0; i < 2; ++i)
+                for (size_t j = 0; j < 3; ++j)
+                    assert(is_close(r(i, j), a(i, j) * 2.0f + b(i, j) - c(i, j)));
+            std::cout << "a * s + b - c se evalua en un solo recorrido al asignarse\n";
+
+            Tensor<float, 2> row(1, 3), col(2, 1);
+            row = {10.0f, 20.0f, 30.0f};
+            col = {100.0f, 200.0f};
+            Tensor<float, 2> bc = (a + row) * 2.0f + col;
+            assert(bc.shape()[0] == 2 && bc.shape()[1] == 3);
+            assert(is_close(bc(0, 0), 122.0f) && is_close(bc(1, 2), 272.0f));
+            Tensor<float, 2> rc = 1.0f - row / 10.0f;
+            assert(is_close(rc(0, 2), -2.0f));
+            std::cout << "Broadcasting y escalares a ambos lados dentro de la expresion\n";
+
+            const float* buffer = r.raw_data();
+            r = r * r - a;
+            assert(r.raw_data() == buffer);
+            assert(is_close(r(0, 0), 1.5f * 1.5f - 1.0f));
+            col = col + row;
+            assert(col.shape()[1] == 3 && is_close(col(1, 2), 230.0f));
+            std::cout << "Asignar a un operando de la propia expresion es seguro\n";
+
+            auto owned = Tensor<float, 2>(a) * 3.0f;
+            a.fill(0.0f);
+            Tensor<float, 2> o = owned;
+            assert(is_close(o(1, 2), 18.0f));
+            std::cout << "Los temporales quedan dentro de la expresion\n";
+
+            Tensor<float, 2> acc(2, 3);
+            acc += b * 4.0f + row;
+            assert(is_close(acc(1, 1), 22.0f));
+
+            bool threw = false;
+            try {
+                Tensor<float, 2> wide(2, 5);
+                auto bad = a + wide;
+                (void)bad;
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de expresiones: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Expresiones perezosas", all_passed);
+    }
+
+    void test_broadcast_paths() {
+        print_test_header("TEST RUTAS DE BROADCASTING");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(11);
+            Tensor<float, 3> a(2, 1, 4), b(1, 3, 1);
+            auto va = random_matrix<float>(2, 4, gen);
+            auto vb = random_matrix<float>(1, 3, gen);
+            std::copy(va.begin(), va.end(), a.begin());
+            std::copy(vb.begin(), vb.end(), b.begin());
+            Tensor<float, 3> r = a * b - a;
+            assert(r.shape()[0] == 2 && r.shape()[1] == 3 && r.shape()[2] == 4);
+            for (size_t i = 0; i < 2; ++i)
+                for (size_t j = 0; j < 3; ++j)
+                    for (size_t k = 0; k < 4; ++k)
+                        assert(is_close(r(i, j, k), a(i, 0, k) * b(0, j, 0) - a(i, 0, k)));
+            std::cout << "Broadcast en varias dimensiones a la vez coincide con la referencia\n";
+
+            Tensor<float, 2> y(5, 7), bias(1, 7), col(5, 1);
+            auto vy = random_matrix<float>(5, 7, gen);
+            std::copy(vy.begin(), vy.end(), y.begin());
+            for (size_t j = 0; j < 7; ++j) bias(0, j) = static_cast<float>(j);
+            for (size_t i = 0; i < 5; ++i) col(i, 0) = static_cast<float>(10 * i);
+            Tensor<float, 2> expected = y;
+            y += bias;
+            y -= col;
+            for (size_t i = 0; i < 5; ++i)
+                for (size_t j = 0; j < 7; ++j)
+                    assert(is_close(y(i, j), expected(i, j) + j - 10.0f * i));
+            std::cout << "Suma de bias por filas y resta por columnas en sitio\n";
+
+            Tensor<float, 1> v(5), one(1);
+            v = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+            one = {2.0f};
+            Tensor<float, 1> w = v * one + one;
+            assert(w.shape()[0] == 5 && is_close(w(4), 12.0f));
+
+            Tensor<float, 2> empty(0, 7);
+            Tensor<float, 2> e = empty + bias * 2.0f;
+            assert(e.size() == 0 && e.shape()[1] == 7);
+            std::cout << "Rango 1 y tensores vacios\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de broadcasting: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Rutas de broadcasting", all_passed);
+    }
+
+    void test_storage_policies() {
+        print_test_header("TEST POLITICAS DE ALMACENAMIENTO");
+
+        bool all_passed = true;
+
+        try {
+            using utec::algebra::HugePageStorage;
+            using utec::algebra::ExternalStorage;
+
+            for (size_t n : {1, 3, 17, 1000}) {
+                Tensor<float, 2> t(n, 3);
+                assert(reinterpret_cast<uintptr_t>(t.raw_data()) % 64 == 0);
+            }
+            std::cout << "El almacenamiento por defecto esta alineado a 64 bytes\n";
+
+            Tensor<float, 2, HugePageStorage> big(1024, 1024);
+            assert(reinterpret_cast<uintptr_t>(big.raw_data()) % (2u << 20) == 0);
+            big.fill(1.5f);
+            Tensor<float, 2, HugePageStorage> small(1, 1024);
+            small.fill(0.5f);
+            Tensor<float, 2> sum = big + small;
+            assert(is_close(sum(1023, 1023), 2.0f));
+            std::cout << "Tensores grandes en paginas de 2 MiB interoperan con los normales\n";
+
+            std::vector<float> buffer = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+            auto ext = utec::algebra::adopt_buffer(buffer.data(), std::array<size_t, 2>{2, 3});
+            assert(ext.raw_data() == buffer.data() && is_close(ext(1, 2), 6.0f));
+            ext *= 2.0f;
+            assert(is_close(buffer[5], 12.0f));
+            Tensor<float, 2> w(3, 2);
+            w.fill(1.0f);
+            auto prod = utec::algebra::matrix_product(ext, w);
+            assert(is_close(prod(0, 0), 12.0f) && is_close(prod(1, 1), 30.0f));
+            ext.reshape({3, 2});
+            ext.reshape({1, 6});
+            bool threw = false;
+            try {
+                ext.reshape({4, 4});
+            } catch (const std::length_error&) {
+                threw = true;
+            }
+            assert(threw);
+            std::cout << "Un buffer externo se adopta sin copia y no crece mas alla de su capacidad\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de almacenamiento: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Politicas de almacenamiento", all_passed);
+    }
+
+    void test_bounds_policy() {
+        print_test_header("TEST POLITICA DE COMPROBACION DE INDICES");
+
+        bool all_passed = true;
+
+        try {
+            Tensor<float, 2> t(2, 3);
+            t.at(1, 2) = 5.0f;
+            assert(is_close(t(1, 2), 5.0f));
+
+            bool threw = false;
+            try {
+                t.at(2, 0) = 1.0f;
+            } catch (const std::out_of_range&) {
+                threw = true;
+            }
+            assert(threw);
+            std::cout << "at() comprueba los indices siempre\n";
+
+            if constexpr (utec::algebra::bounds_checked) {
+                threw = false;
+                try {
+                    t(0, 3) = 1.0f;
+                } catch (const std::out_of_range&) {
+                    threw = true;
+                }
+                assert(threw);
+
+                threw = false;
+                try {
+                    utec::algebra::TensorView<const float, 2> v(t);
+                    (void)v(2, 0);
+                } catch (const std::out_of_range&) {
+                    threw = true;
+                }
+                assert(threw);
+                std::cout << "operator() comprueba los indices en compilacion debug\n";
+            } else {
+                std::cout << "operator() sin comprobacion (NDEBUG)\n";
+            }
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de indices: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Politica de comprobacion de indices", all_passed);
+    }
+
+    void test_thread_pool_and_parallel_gemm() {
+        print_test_header("TEST POOL DE HILOS Y GEMM PARALELO");
+
+        bool all_passed = true;
+
+        try {
+            ThreadCountGuard threads(4);
+            assert(utec::algebra::num_threads() == 4);
+            auto& pool = utec::algebra::thread_pool();
+
+            std::vector<int> hits(1000, 0);
+            pool.parallel_for(hits.size(), [&](size_t i) { hits[i] += 1; });
+            for (int h : hits) assert(h == 1);
+
+            std::vector<size_t> sums(8, 0);
+            pool.parallel_for(sums.size(), [&](size_t i) {
+                pool.parallel_for(10, [&](size_t j) { sums[i] += j; });
+            });
+            for (size_t s : sums) assert(s == 45);
+
+            bool threw = false;
+            try {
+                pool.parallel_for(100, [](size_t i) {
+                    if (i == 37) throw std::runtime_error("fallo en tarea");
+                });
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            assert(threw);
+            std::cout << "parallel_for cubre cada indice, admite anidamiento y propaga excepciones\n";
+
+            std::mt19937 gen(5);
+            const size_t sizes[][3] = {{300, 200, 150}, {1000, 37, 64}, {7, 2000, 300}, {129, 130, 131}};
+            for (const auto& sz : sizes) {
+                const size_t m = sz[0], n = sz[1], k = sz[2];
+                auto a = random_matrix<float>(m, k, gen);
+                auto b = random_matrix<float>(k, n, gen);
+                std::vector<float> parallel(m * n), serial(m * n);
+                utec::algebra::gemm(m, n, k, a.data(), k, b.data(), n, parallel.data(), n);
+                utec::algebra::set_num_threads(1);
+                utec::algebra::gemm(m, n, k, a.data(), k, b.data(), n, serial.data(), n);
+                utec::algebra::set_num_threads(4);
+                for (size_t i = 0; i < m * n; ++i) assert(is_close(parallel[i], serial[i], 1e-4f));
+            }
+            std::cout << "GEMM repartido en teselas M x N coincide con la version de un hilo\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de hilos: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Pool de hilos y GEMM paralelo", all_passed);
+    }
+
+    void test_blocked_transpose() {
+        print_test_header("TEST TRANSPUESTA POR BLOQUES");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(21);
+            const GemmIsa original = utec::algebra::gemm_isa();
+            for (GemmIsa isa : {GemmIsa::Scalar, GemmIsa::AVX2}) {
+                if (!utec::algebra::set_gemm_isa(isa)) continue;
+
+                const size_t shapes[][2] = {{1, 1}, {7, 13}, {8, 8}, {33, 65}, {100, 37}, {256, 256}};
+                for (const auto& sh : shapes) {
+                    Tensor<float, 2> m(sh[0], sh[1]);
+                    auto values = random_matrix<float>(sh[0], sh[1], gen);
+                    std::copy(values.begin(), values.end(), m.begin());
+                    auto t = utec::algebra::transpose_2d(m);
+                    assert(t.shape()[0] == sh[1] && t.shape()[1] == sh[0]);
+                    for (size_t i = 0; i < sh[0]; ++i)
+                        for (size_t j = 0; j < sh[1]; ++j)
+                            assert(t(j, i) == m(i, j));
+                }
+
+                for (size_t n : {1, 5, 8, 40, 67, 128}) {
+                    Tensor<float, 2> m(n, n);
+                    auto values = random_matrix<float>(n, n, gen);
+                    std::copy(values.begin(), values.end(), m.begin());
+                    Tensor<float, 2> original_m = m;
+                    utec::algebra::transpose_2d_inplace(m);
+                    for (size_t i = 0; i < n; ++i)
+                        for (size_t j = 0; j < n; ++j)
+                            assert(m(j, i) == original_m(i, j));
+                }
+                std::cout << "Transpuesta correcta con kernel " << utec::algebra::gemm_isa_name(isa) << "\n";
+            }
+            utec::algebra::set_gemm_isa(original);
+
+            Tensor<double, 3> batch(2, 3, 4);
+            for (size_t i = 0; i < batch.size(); ++i) batch[i] = static_cast<double>(i);
+            auto bt = utec::algebra::transpose_2d(batch);
+            assert(bt.shape()[0] == 2 && bt.shape()[1] == 4 && bt.shape()[2] == 3);
+            assert(bt(1, 3, 2) == batch(1, 2, 3));
+            std::cout << "Con Rank 3 se transpone cada matriz del lote\n";
+
+            bool threw = false;
+            try {
+                Tensor<float, 2> rect(3, 4);
+                utec::algebra::transpose_2d_inplace(rect);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de transpuesta: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Transpuesta por bloques", all_passed);
+    }
+
+    void test_static_tensor() {
+        print_test_header("TEST TENSOR DE FORMA ESTATICA");
+
+        bool all_passed = true;
+
+        try {
+            using utec::algebra::StaticTensor;
+            using Small = StaticTensor<float, 2, 3, 4>;
+            static_assert(Small::rank == 3 && Small::size() == 24);
+            static_assert(Small::strides()[0] == 12 && Small::strides()[1] == 4 && Small::strides()[2] == 1);
+            static_assert(Small::is_inline && !StaticTensor<float, 64, 64>::is_inline);
+            std::cout << "Forma, strides y tamano son constantes de compilacion\n";
+
+            Small s;
+            for (size_t i = 0; i < s.size(); ++i) assert(s[i] == 0.0f);
+            s(1, 2, 3) = 5.0f;
+            assert(s[23] == 5.0f);
+            utec::algebra::TensorView<const float, 3> sv = s;
+            assert(sv(1, 2, 3) == 5.0f && sv.is_contiguous());
+
+            // Producto con kernel de tamano fijo y con GEMM, contra el producto dinamico
+            std::mt19937 gen(23);
+            auto check = [&](auto&& a, auto&& b) {
+                auto av = random_matrix<float>(a.shape()[0], a.shape()[1], gen);
+                auto bv = random_matrix<float>(b.shape()[0], b.shape()[1], gen);
+                std::copy(av.begin(), av.end(), a.begin());
+                std::copy(bv.begin(), bv.end(), b.begin());
+                auto c = utec::algebra::matrix_product(a, b);
+                auto expected = utec::algebra::matrix_product(a.to_tensor(), b.to_tensor());
+                assert(c.shape() == expected.shape());
+                for (size_t i = 0; i < c.size(); ++i) assert(is_close(c[i], expected[i], 1e-4f));
+            };
+            check(StaticTensor<float, 5, 7>{}, StaticTensor<float, 7, 3>{});
+            check(StaticTensor<float, 33, 100>{}, StaticTensor<float, 100, 70>{});
+            std::cout << "matrix_product estatico coincide con el dinamico\n";
+
+            StaticTensor<double, 2, 2> m{1.0, 2.0, 3.0, 4.0};
+            StaticTensor<double, 2, 2> copy(m.to_tensor());
+            assert(copy == m);
+            copy += m;
+            copy *= 0.5;
+            assert(copy == m);
+
+            bool threw = false;
+            try {
+                StaticTensor<float, 2, 2> bad(Tensor<float, 2>(2, 3));
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+
+            if constexpr (utec::algebra::bounds_checked) {
+                threw = false;
+                try {
+                    (void)m(2, 0);
+                } catch (const std::out_of_range&) {
+                    threw = true;
+                }
+                assert(threw);
+            }
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de tensor estatico: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Tensor de forma estatica", all_passed);
+    }
+
+    template<typename TensorType>
+    static bool stored_inline(const TensorType& t) {
+        const char* p = reinterpret_cast<const char*>(t.raw_data());
+        const char* self = reinterpret_cast<const char*>(&t);
+        return p >= self && p < self + sizeof(t);
+    }
+
+    void test_small_buffer_storage() {
+        print_test_header("TEST ALMACENAMIENTO EN LINEA PARA TENSORES PEQUENOS");
+
+        bool all_passed = true;
+
+        try {
+            using utec::algebra::SmallTensor;
+            // Escalar, fila de bias y temporal 1xN: sin memoria del heap
+            SmallTensor<float, 2> scalar;
+            SmallTensor<float, 2> bias(1, 32);
+            bias.fill(0.0f);
+            SmallTensor<float, 2> row = bias * 2.0f;
+            assert(stored_inline(scalar) && stored_inline(bias) && stored_inline(row));
+            assert(reinterpret_cast<uintptr_t>(bias.raw_data()) % utec::algebra::default_alignment == 0);
+            std::cout << "SmallTensor de hasta " << UTEC_TENSOR_INLINE_BYTES << " bytes se guarda en linea\n";
+
+            // Tensor por defecto: siempre en el heap, objeto pequeño y un movimiento no mueve los datos
+            static_assert(sizeof(Tensor<float, 2>) < 64);
+            Tensor<float, 2> plain_row(1, 32);
+            const float* plain_buffer = plain_row.raw_data();
+            Tensor<float, 2> plain_moved = std::move(plain_row);
+            assert(!stored_inline(plain_moved) && plain_moved.raw_data() == plain_buffer);
+
+            SmallTensor<float, 2> large(64, 64);
+            assert(!stored_inline(large));
+
+            // Al crecer pasa al heap conservando los datos; al encoger conserva el buffer
+            SmallTensor<float, 1> v(4);
+            for (size_t i = 0; i < 4; ++i) v[i] = static_cast<float>(i + 1);
+            v.reshape({1000});
+            assert(!stored_inline(v) && v[0] == 1.0f && v[3] == 4.0f && v[999] == 0.0f);
+            const float* heap_buffer = v.raw_data();
+            v.reshape({2});
+            v.reshape({1000});
+            assert(v.raw_data() == heap_buffer && v[1] == 2.0f);
+
+            // Copias y movimientos de tensores en linea y en el heap
+            SmallTensor<float, 2> small_copy = bias;
+            small_copy(0, 3) = 7.0f;
+            assert(bias(0, 3) == 0.0f && stored_inline(small_copy));
+            SmallTensor<float, 2> small_moved = std::move(small_copy);
+            assert(small_moved(0, 3) == 7.0f && stored_inline(small_moved));
+            const float* large_buffer = large.raw_data();
+            SmallTensor<float, 2> large_moved = std::move(large);
+            assert(large_moved.raw_data() == large_buffer);
+            small_moved = std::move(large_moved);
+            assert(small_moved.raw_data() == large_buffer && small_moved.shape()[0] == 64);
+
+            // Capacidad configurable por tensor
+            Tensor<double, 1, utec::algebra::SmallStorage<1024>> wide(128);
+            Tensor<double, 1, utec::algebra::SmallStorage<1024>> too_wide(129);
+            assert(stored_inline(wide) && !stored_inline(too_wide));
+            std::cout << "SmallStorage<1024> guarda 128 doubles en linea\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de almacenamiento en linea: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Almacenamiento en linea para tensores pequenos", all_passed);
+    }
+
+    void test_axis_reductions() {
+        print_test_header("TEST REDUCCIONES POR EJE");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(29);
+            for (size_t rows : {1, 3, 17, 300}) {
+                for (size_t cols : {1, 5, 16, 37}) {
+                    Tensor<double, 2> m(rows, cols);
+                    auto values = random_matrix<double>(rows, cols, gen);
+                    std::copy(values.begin(), values.end(), m.begin());
+
+                    auto col_sum = utec::algebra::reduce_sum(m, 0);
+                    auto row_sum = utec::algebra::reduce_sum(m, 1);
+                    auto col_max = utec::algebra::reduce_max(m, 0);
+                    auto row_arg = utec::algebra::argmax(m, 1);
+                    auto col_arg = utec::algebra::argmax(m, 0);
+                    auto row_mean = utec::algebra::mean(m, 1);
+                    assert(col_sum.shape()[0] == 1 && col_sum.shape()[1] == cols);
+                    assert(row_sum.shape()[0] == rows && row_sum.shape()[1] == 1);
+
+                    for (size_t j = 0; j < cols; ++j) {
+                        double sum = 0.0, best = m(0, j);
+                        size_t best_i = 0;
+                        for (size_t i = 0; i < rows; ++i) {
+                            sum += m(i, j);
+                            if (m(i, j) > best) { best = m(i, j); best_i = i; }
+                        }
+                        assert(std::abs(col_sum(0, j) - sum) < 1e-9);
+                        assert(col_max(0, j) == best && col_arg(0, j) == best_i);
+                    }
+                    for (size_t i = 0; i < rows; ++i) {
+                        double sum = 0.0, best = m(i, 0);
+                        size_t best_j = 0;
+                        for (size_t j = 0; j < cols; ++j) {
+                            sum += m(i, j);
+                            if (m(i, j) > best) { best = m(i, j); best_j = j; }
+                        }
+                        assert(std::abs(row_sum(i, 0) - sum) < 1e-9);
+                        assert(std::abs(row_mean(i, 0) - sum / static_cast<double>(cols)) < 1e-9);
+                        assert(row_arg(i, 0) == best_j);
+                    }
+                }
+            }
+            std::cout << "Suma, maximo, argmax y media coinciden con bucles de referencia\n";
+
+            // float usa kernels AVX salvo con el ISA escalar: ambos caminos dan lo mismo
+            const GemmIsa original = utec::algebra::gemm_isa();
+            Tensor<float, 2> f(300, 45);
+            auto fvalues = random_matrix<float>(300, 45, gen);
+            std::copy(fvalues.begin(), fvalues.end(), f.begin());
+            for (GemmIsa isa : {GemmIsa::Scalar, GemmIsa::AVX2}) {
+                if (!utec::algebra::set_gemm_isa(isa)) continue;
+                auto fsum = utec::algebra::reduce_sum(f, 0);
+                auto fmax = utec::algebra::reduce_max(f, 0);
+                auto frow = utec::algebra::reduce_sum(f, 1);
+                for (size_t j = 0; j < 45; ++j) {
+                    float sum = 0.0f, best = f(0, j);
+                    for (size_t i = 0; i < 300; ++i) {
+                        sum += f(i, j);
+                        best = std::max(best, f(i, j));
+                    }
+                    assert(is_close(fsum(0, j), sum, 1e-3f) && fmax(0, j) == best);
+                }
+                for (size_t i = 0; i < 300; ++i) {
+                    float sum = 0.0f;
+                    for (size_t j = 0; j < 45; ++j) sum += f(i, j);
+                    assert(is_close(frow(i, 0), sum, 1e-4f));
+                }
+            }
+            utec::algebra::set_gemm_isa(original);
+
+            // Eje intermedio de un Rank 3, vista no contigua y empates (gana el primero)
+            Tensor<float, 3> cube(2, 3, 4);
+            for (size_t i = 0; i < cube.size(); ++i) cube[i] = static_cast<float>(i % 5);
+            auto mid = utec::algebra::reduce_sum(cube, 1);
+            assert(mid.shape()[0] == 2 && mid.shape()[1] == 1 && mid.shape()[2] == 4);
+            assert(mid(1, 0, 2) == cube(1, 0, 2) + cube(1, 1, 2) + cube(1, 2, 2));
+            Tensor<float, 2> ties(1, 4);
+            ties = {1.0f, 3.0f, 3.0f, 2.0f};
+            assert(utec::algebra::argmax(ties, 1)[0] == 1);
+            Tensor<float, 2> base(4, 3);
+            for (size_t i = 0; i < base.size(); ++i) base[i] = static_cast<float>(i);
+            const std::vector<size_t> order{3, 0};
+            auto picked = utec::algebra::reduce_sum(utec::algebra::gather(base, order), 1);
+            assert(picked(0, 0) == 9.0f + 10.0f + 11.0f && picked(1, 0) == 0.0f + 1.0f + 2.0f);
+
+            // Suma por pares: 2^20 veces 0.1f sin la deriva de la suma secuencial
+            Tensor<float, 1> many(1u << 20);
+            many.fill(0.1f);
+            const float total = utec::algebra::reduce_sum(many, 0)[0];
+            assert(std::abs(total - 104857.6f) < 1.0f);
+            std::cout << "Suma por pares de 2^20 valores 0.1f: " << total << "\n";
+
+            bool threw = false;
+            try {
+                (void)utec::algebra::reduce_sum(base, 2);
+            } catch (const std::out_of_range&) {
+                threw = true;
+            }
+            assert(threw);
+            threw = false;
+            try {
+                (void)utec::algebra::reduce_max(Tensor<float, 2>(3, 0), 1);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de reducciones: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Reducciones por eje", all_passed);
+    }
+
+    template<size_t Rank>
+    bool check_batched(const Tensor<float, Rank>& a, const Tensor<float, Rank>& b) {
+        auto c = utec::algebra::matrix_product(a, b);
+        const size_t m = a.shape()[Rank - 2], k = a.shape()[Rank - 1], n = b.shape()[Rank - 1];
+        const size_t batch = c.size() / (m * n);
+        const size_t step_a = a.size() == m * k ? 0 : m * k;
+        const size_t step_b = b.size() == k * n ? 0 : k * n;
+        for (size_t i = 0; i < batch; ++i) {
+            std::vector<float> va(a.cbegin() + i * step_a, a.cbegin() + i * step_a + m * k);
+            std::vector<float> vb(b.cbegin() + i * step_b, b.cbegin() + i * step_b + k * n);
+            auto expected = reference_product(va, vb, m, n, k);
+            for (size_t j = 0; j < m * n; ++j)
+                if (!is_close(c[i * m * n + j], expected[j], 1e-4f)) return false;
+        }
+        return true;
+    }
+
+    template<size_t Rank>
+    static Tensor<float, Rank> random_tensor(const std::array<size_t, Rank>& shape, std::mt19937& gen) {
+        Tensor<float, Rank> t(shape);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (auto& v : t) v = dist(gen);
+        return t;
+    }
+
+    void test_batched_matrix_product() {
+        print_test_header("TEST PRODUCTO MATRICIAL POR LOTES");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(31);
+            ThreadCountGuard threads(4);
+
+            // Muchos problemas pequenos, pocos grandes y lotes con un operando compartido
+            assert(check_batched(random_tensor<3>({300, 4, 5}, gen), random_tensor<3>({300, 5, 3}, gen)));
+            assert(check_batched(random_tensor<3>({2, 130, 140}, gen), random_tensor<3>({2, 140, 150}, gen)));
+            assert(check_batched(random_tensor<3>({8, 33, 20}, gen), random_tensor<3>({1, 20, 17}, gen)));
+            assert(check_batched(random_tensor<3>({1, 6, 20}, gen), random_tensor<3>({8, 20, 17}, gen)));
+            assert(check_batched(random_tensor<4>({2, 3, 9, 7}, gen), random_tensor<4>({2, 3, 7, 5}, gen)));
+            std::cout << "Cada matriz del lote coincide con el producto de referencia\n";
+
+            auto shared = utec::algebra::matrix_product(random_tensor<3>({1, 6, 20}, gen), random_tensor<3>({8, 20, 17}, gen));
+            assert(shared.shape()[0] == 8 && shared.shape()[1] == 6 && shared.shape()[2] == 17);
+
+            bool threw = false;
+            try {
+                utec::algebra::matrix_product(Tensor<float, 3>(2, 3, 4), Tensor<float, 3>(3, 4, 5));
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+            threw = false;
+            try {
+                utec::algebra::matrix_product(Tensor<float, 3>(2, 3, 4), Tensor<float, 3>(2, 3, 5));
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de producto por lotes: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Producto matricial por lotes", all_passed);
+    }
+
+    void test_half_precision() {
+        print_test_header("TEST BF16 / FP16");
+
+        bool all_passed = true;
+
+        try {
+            using utec::algebra::bf16;
+            using utec::algebra::fp16;
+
+            // Redondeo al par más cercano y casos límite
+            assert(float(bf16(1.0f)) == 1.0f && sizeof(bf16) == 2);
+            assert(float(bf16(1.00390625f)) == 1.0f);          // empate -> par
+            assert(float(bf16(1.01171875f)) == 1.015625f);
+            assert(float(bf16(3.0e38f)) > 2.9e38f);            // mismo rango que float
+            assert(float(fp16(65504.0f)) == 65504.0f);
+            assert(std::isinf(float(fp16(65520.0f))));
+            assert(float(fp16(5.9604645e-8f)) == 5.9604645e-8f);   // menor subnormal
+            assert(float(fp16(1.0e-8f)) == 0.0f);
+            assert(std::isnan(float(bf16(NAN))) && std::isnan(float(fp16(NAN))));
+            assert(float(std::numeric_limits<bf16>::max()) > 3.3e38f);
+            assert(float(std::numeric_limits<fp16>::max()) == 65504.0f);
+            std::cout << "Conversion escalar con redondeo al par\n";
+
+            // Las conversiones por bloques (F16C / AVX2 / AVX-512 BF16) coinciden con la escalar
+            std::mt19937 gen(15);
+            std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+            std::vector<float> src(1031), back(src.size());
+            for (auto& v : src) v = dist(gen) * std::ldexp(1.0f, static_cast<int>(gen() % 40) - 30);
+            std::vector<bf16> as_bf16(src.size());
+            std::vector<fp16> as_fp16(src.size());
+            utec::algebra::convert(src.data(), as_bf16.data(), src.size());
+            utec::algebra::convert(src.data(), as_fp16.data(), src.size());
+            for (size_t i = 0; i < src.size(); ++i) {
+                assert(as_bf16[i].bits() == bf16(src[i]).bits());
+                assert(as_fp16[i].bits() == fp16(src[i]).bits());
+            }
+            utec::algebra::convert(as_bf16.data(), back.data(), src.size());
+            for (size_t i = 0; i < src.size(); ++i) assert(back[i] == float(as_bf16[i]));
+            utec::algebra::convert(as_fp16.data(), back.data(), src.size());
+            for (size_t i = 0; i < src.size(); ++i) assert(back[i] == float(as_fp16[i]));
+            std::cout << "Conversion por bloques igual a la escalar\n";
+
+            // GEMM con acumulación en float: solo se redondea el resultado final
+            auto check_gemm = [&](auto tag, size_t m, size_t n, size_t k) {
+                using H = decltype(tag);
+                auto make = [&](size_t rows, size_t cols) {
+                    Tensor<H, 2> t(rows, cols);
+                    auto values = random_matrix<float>(rows, cols, gen);
+                    utec::algebra::convert(values.data(), t.raw_data(), values.size());
+                    return t;
+                };
+                auto a = make(m, k);
+                auto b = make(k, n);
+                auto a32 = utec::algebra::tensor_cast<float>(a);
+                auto b32 = utec::algebra::tensor_cast<float>(b);
+                auto expected = reference_product(std::vector<float>(a32.begin(), a32.end()),
+                                                  std::vector<float>(b32.begin(), b32.end()), m, n, k);
+                auto c = utec::algebra::matrix_product(a, b);
+                const float ulp = float(std::numeric_limits<H>::epsilon());
+                for (size_t i = 0; i < m * n; ++i)
+                    if (std::abs(float(c[i]) - expected[i]) > ulp * (std::abs(expected[i]) + 1e-3f)) return false;
+                return true;
+            };
+            for (auto isa : {utec::algebra::GemmIsa::Scalar, utec::algebra::gemm_isa()}) {
+                const auto previous = utec::algebra::gemm_isa();
+                utec::algebra::set_gemm_isa(isa);
+                assert(check_gemm(bf16{}, 7, 9, 5));
+                assert(check_gemm(bf16{}, 70, 130, 300));
+                assert(check_gemm(fp16{}, 70, 130, 300));
+                utec::algebra::set_gemm_isa(previous);
+            }
+            std::cout << "GEMM bf16 / fp16 con acumulacion en float\n";
+
+            // Operaciones elemento a elemento y reducciones sobre Tensor<bf16, 2>
+            Tensor<bf16, 2> x(2, 3), y(2, 3);
+            for (size_t i = 0; i < x.size(); ++i) {
+                x[i] = bf16(static_cast<float>(i));
+                y[i] = bf16(0.5f);
+            }
+            Tensor<bf16, 2> z = x + y * bf16(2.0f);
+            assert(float(z(1, 2)) == 6.0f);
+            Tensor<bf16, 2> ones(1, 4096);
+            ones.fill(bf16(1.0f));
+            // Sumando en bf16 el total se estancaría en 256
+            assert(float(utec::algebra::reduce_sum(ones, 1)(0, 0)) == 4096.0f);
+            std::cout << "Tensor<bf16, 2>: aritmetica y reducciones en float\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test bf16 / fp16: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Tipos bf16 / fp16", all_passed);
+    }
+
+    void test_int8_gemm() {
+        print_test_header("TEST GEMM INT8 (U8 x S8 -> S32)");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(16);
+            std::uniform_int_distribution<int> act(0, utec::algebra::int8_activation_max);
+            std::uniform_int_distribution<int> wgt(-utec::algebra::int8_weight_max, utec::algebra::int8_weight_max);
+
+            // Resultado exacto frente a la referencia con VNNI, maddubs y escalar;
+            // valores extremos incluidos (127 * 127 es el peor caso para maddubs)
+            auto check = [&](size_t m, size_t n, size_t k, bool extreme) {
+                std::vector<int8_t> b(k * n);
+                for (auto& v : b) v = static_cast<int8_t>(extreme ? (gen() % 2 ? 127 : -127) : wgt(gen));
+                auto packed = utec::algebra::pack_int8(b.data(), k, n, n);
+                const size_t lda = packed.padded_k();
+                std::vector<uint8_t> a(m * lda, 0xff);   // el relleno no debe influir
+                for (size_t i = 0; i < m; ++i)
+                    for (size_t p = 0; p < k; ++p) a[i * lda + p] = static_cast<uint8_t>(extreme ? 127 : act(gen));
+
+                std::vector<int32_t> c(m * n, -1);
+                utec::algebra::gemm_u8s8(m, a.data(), lda, packed, [&](size_t i, const int32_t* row) {
+                    std::copy(row, row + n, c.begin() + i * n);
+                });
+                for (size_t j = 0; j < n; ++j) {
+                    int32_t sum = 0;
+                    for (size_t p = 0; p < k; ++p) sum += b[p * n + j];
+                    if (packed.col_sums[j] != sum) return false;
+                }
+                for (size_t i = 0; i < m; ++i)
+                    for (size_t j = 0; j < n; ++j) {
+                        int32_t expected = 0;
+                        for (size_t p = 0; p < k; ++p) expected += int32_t(a[i * lda + p]) * b[p * n + j];
+                        if (c[i * n + j] != expected) return false;
+                    }
+                return true;
+            };
+
+            const auto previous = utec::algebra::gemm_isa();
+            for (auto isa : {GemmIsa::Scalar, GemmIsa::AVX2, GemmIsa::AVX512}) {
+                if (!utec::algebra::set_gemm_isa(isa)) continue;
+                assert(check(1, 1, 1, false));
+                assert(check(5, 10, 64, false));
+                assert(check(7, 17, 6, false));
+                assert(check(13, 70, 130, false));
+                assert(check(4, 64, 128, true));
+                std::cout << "GEMM int8 exacto con " << utec::algebra::gemm_isa_name(isa) << "\n";
+            }
+            utec::algebra::set_gemm_isa(previous);
+
+            // Cuantización y epílogo: mismo resultado con AVX2 que en escalar
+            std::vector<float> x(37);
+            std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+            for (auto& v : x) v = dist(gen);
+            std::vector<int32_t> acc(x.size());
+            for (auto& v : acc) v = static_cast<int32_t>(gen() % 40000) - 20000;
+            std::vector<float> mult(x.size(), 0.004f), off(x.size(), 60.0f);
+            auto run = [&](GemmIsa isa, std::vector<uint8_t>& q, std::vector<uint8_t>& r, std::vector<float>& d) {
+                utec::algebra::set_gemm_isa(isa);
+                utec::algebra::quantize_u7(x.data(), x.size(), 20.0f, 64, q.data());
+                utec::algebra::requantize_u7(acc.data(), acc.size(), mult.data(), off.data(), 64, r.data());
+                utec::algebra::dequantize_i32(acc.data(), acc.size(), mult.data(), off.data(), true, d.data());
+            };
+            std::vector<uint8_t> q0(x.size()), r0(x.size()), q1(x.size()), r1(x.size());
+            std::vector<float> d0(x.size()), d1(x.size());
+            run(GemmIsa::Scalar, q0, r0, d0);
+            run(previous, q1, r1, d1);
+            utec::algebra::set_gemm_isa(previous);
+            assert(q0 == q1 && r0 == r1 && d0 == d1);
+            for (size_t i = 0; i < x.size(); ++i) {
+                const int expected = std::clamp(static_cast<int>(std::nearbyint(x[i] * 20.0f)) + 64, 0, 127);
+                assert(q0[i] == expected);
+                assert(r0[i] >= 64 && r0[i] <= 127);      // ReLU fusionada: nunca bajo el punto cero
+                assert(d0[i] >= 0.0f);
+            }
+            std::cout << "Cuantizacion y recuantizacion con ReLU fusionada\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test int8: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("GEMM int8 y recuantizacion", all_passed);
+    }
+
+    void test_sparse_matrix_product() {
+        print_test_header("TEST PRODUCTO CSR (ENTRADAS DISPERSAS)");
+
+        bool all_passed = true;
+
+        try {
+            std::mt19937 gen(17);
+            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+            auto sparse_random = [&](size_t r, size_t c, double density) {
+                Tensor<float, 2> t(r, c);
+                std::bernoulli_distribution keep(density);
+                for (size_t i = 0; i < t.size(); ++i) t[i] = keep(gen) ? dist(gen) : 0.0f;
+                return t;
+            };
+            auto random = [&](size_t r, size_t c) {
+                Tensor<float, 2> t(r, c);
+                for (size_t i = 0; i < t.size(); ++i) t[i] = dist(gen);
+                return t;
+            };
+
+            // Anchos impares para cubrir colas enmascaradas y el resto escalar
+            utec::algebra::CsrMatrix<float> csr;
+            auto check = [&](size_t m, size_t k, size_t n, double density) {
+                auto a = sparse_random(m, k, density);
+                auto b = random(k, n);
+                auto g = random(m, n);
+                csr.assign(a);
+                if (csr.rows() != m || csr.cols() != k) return false;
+                auto back = csr.to_dense();
+                for (size_t i = 0; i < a.size(); ++i)
+                    if (back[i] != a[i]) return false;
+
+                Tensor<float, 2> out(0, 0), out_tn(0, 0);
+                utec::algebra::sparse_matrix_product_into(csr, b, out);
+                utec::algebra::sparse_matrix_product_tn_into(csr, g, out_tn);
+                auto ref = utec::algebra::matrix_product(a, b);
+                auto ref_tn = utec::algebra::matrix_product_tn(a, g);
+                if (out.shape() != ref.shape() || out_tn.shape() != ref_tn.shape()) return false;
+                for (size_t i = 0; i < ref.size(); ++i)
+                    if (!is_close(out[i], ref[i], 1e-4f)) return false;
+                for (size_t i = 0; i < ref_tn.size(); ++i)
+                    if (!is_close(out_tn[i], ref_tn[i], 1e-4f)) return false;
+                return true;
+            };
+
+            const auto previous = utec::algebra::gemm_isa();
+            for (auto isa : {GemmIsa::Scalar, GemmIsa::AVX2, GemmIsa::AVX512}) {
+                if (!utec::algebra::set_gemm_isa(isa)) continue;
+                assert(check(1, 1, 1, 1.0));
+                assert(check(5, 64, 128, 0.37));
+                assert(check(7, 33, 17, 0.2));
+                assert(check(13, 70, 130, 0.5));
+                assert(check(4, 19, 200, 0.1));
+                assert(check(3, 16, 9, 0.0));
+                std::cout << "CSR x denso y CSR^T x denso con " << utec::algebra::gemm_isa_name(isa) << "\n";
+            }
+            utec::algebra::set_gemm_isa(previous);
+
+            // density no cuenta los ceros y acepta vistas
+            auto a = sparse_random(6, 40, 0.25);
+            size_t nz = 0;
+            for (size_t i = 0; i < a.size(); ++i) nz += a[i] != 0.0f;
+            csr.assign(a);
+            assert(csr.nnz() == nz);
+            assert(std::abs(utec::algebra::density(a) - static_cast<double>(nz) / 240.0) < 1e-12);
+            assert(std::abs(utec::algebra::density(utec::algebra::rows(a, 0, 6)) - csr.density()) < 1e-12);
+
+            // Dense elige CSR con entradas dispersas y produce los mismos pesos que el GEMM
+            utec::neural_network::Dense<float> sparse_layer(40, 24, ramp_init, ramp_init);
+            utec::neural_network::Dense<float> dense_layer(40, 24, ramp_init, ramp_init);
+            dense_layer.set_sparse_threshold(0.0);
+            utec::neural_network::SGD<float> sgd(0.1f);
+            auto grad = random(6, 24);
+            auto y_sparse = sparse_layer.forward(a);
+            auto y_dense = dense_layer.forward(a);
+            assert(sparse_layer.sparse_input() && !dense_layer.sparse_input());
+            auto gx_sparse = sparse_layer.backward(grad);
+            auto gx_dense = dense_layer.backward(grad);
+            sparse_layer.update_params(sgd);
+            dense_layer.update_params(sgd);
+            for (size_t i = 0; i < y_dense.size(); ++i)
+                all_passed = all_passed && is_close(y_sparse[i], y_dense[i], 1e-5f);
+            for (size_t i = 0; i < gx_dense.size(); ++i)
+                all_passed = all_passed && is_close(gx_sparse[i], gx_dense[i], 1e-5f);
+            for (size_t i = 0; i < dense_layer.weights().size(); ++i)
+                all_passed = all_passed && is_close(sparse_layer.weights()[i], dense_layer.weights()[i], 1e-5f);
+            assert(all_passed);
+
+            // Con una entrada densa no se convierte
+            sparse_layer.forward(random(6, 40));
+            assert(!sparse_layer.sparse_input());
+            std::cout << "Dense: ruta CSR equivalente a la densa en forward y backward\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test CSR: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Producto CSR por matriz densa", all_passed);
+    }
+
+    void test_fused_dense() {
+        print_test_header("TEST CAPA DENSA FUSIONADA (EPILOGO GEMM)");
+
+        bool all_passed = true;
+
+        try {
+            using utec::neural_network::Dense;
+            using utec::neural_network::FusedDense;
+            using utec::neural_network::ReLU;
+            using utec::neural_network::Sigmoid;
+            using utec::neural_network::SGD;
+            using utec::neural_network::NeuralNetwork;
+            using utec::neural_network::LayerFactory;
+            std::mt19937 gen(19);
+            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+            auto random = [&](size_t r, size_t c) {
+                Tensor<float, 2> t(r, c);
+                for (size_t i = 0; i < t.size(); ++i) t[i] = dist(gen);
+                return t;
+            };
+
+            // El epílogo ve cada elemento de C exactamente una vez, ya con el producto completo
+            auto check_epilogue = [&](size_t m, size_t k, size_t n) {
+                auto a = random(m, k);
+                auto b = random(k, n);
+                Tensor<float, 2> out(0, 0);
+                Tensor<int, 2> seen(m, n);
+                seen.fill(0);
+                utec::algebra::matrix_product_into(a, b, out,
+                    [&seen, n](size_t i, size_t j, float* row, size_t cols) {
+                        for (size_t c = 0; c < cols; ++c) {
+                            ++seen[(i * n) + j + c];
+                            row[c] = row[c] > 0.0f ? 2.0f * row[c] : 0.0f;
+                        }
+                    });
+                auto ref = utec::algebra::matrix_product(a, b);
+                for (size_t i = 0; i < ref.size(); ++i) {
+                    const float expected = ref[i] > 0.0f ? 2.0f * ref[i] : 0.0f;
+                    if (seen[i] != 1 || !is_close(out[i], expected, 1e-4f)) return false;
+                }
+                return true;
+            };
+
+            // FusedDense<Act> frente a Dense seguida de la activación: salida, gradiente y pesos
+            auto check_layer = [&](auto fused_tag, auto act_tag, size_t in, size_t out, size_t m, double threshold) {
+                using Fused = typename decltype(fused_tag)::type;
+                using Act = typename decltype(act_tag)::type;
+                Dense<float> dense(in, out, ramp_init, ramp_init);
+                Act act;
+                Fused fused(in, out, ramp_init, ramp_init);
+                dense.set_sparse_threshold(threshold);
+                fused.set_sparse_threshold(threshold);
+                SGD<float> sgd(0.05f);
+                auto x = random(m, in);
+                for (size_t i = 0; i < x.size(); i += 3) x[i] = 0.0f;
+                auto g = random(m, out);
+                auto y_ref = act.forward(dense.forward(x));
+                auto y = fused.forward(x);
+                auto gx_ref = dense.backward(act.backward(g));
+                auto gx = fused.backward(g);
+                dense.update_params(sgd);
+                fused.update_params(sgd);
+                for (size_t i = 0; i < y_ref.size(); ++i)
+                    if (!is_close(y[i], y_ref[i], 1e-4f)) return false;
+                for (size_t i = 0; i < gx_ref.size(); ++i)
+                    if (!is_close(gx[i], gx_ref[i], 1e-4f)) return false;
+                for (size_t i = 0; i < dense.weights().size(); ++i)
+                    if (!is_close(fused.weights()[i], dense.weights()[i], 1e-4f)) return false;
+                for (size_t i = 0; i < dense.bias().size(); ++i)
+                    if (!is_close(fused.bias()[i], dense.bias()[i], 1e-4f)) return false;
+                return true;
+            };
+            auto relu = std::type_identity<FusedDense<float, ReLU>>{};
+            auto relu_act = std::type_identity<ReLU<float>>{};
+            auto sigmoid = std::type_identity<FusedDense<float, Sigmoid>>{};
+            auto sigmoid_act = std::type_identity<Sigmoid<float>>{};
+
+            const auto previous = utec::algebra::gemm_isa();
+            for (auto isa : {GemmIsa::Scalar, GemmIsa::AVX2, GemmIsa::AVX512}) {
+                if (!utec::algebra::set_gemm_isa(isa)) continue;
+                // Caso pequeño, empaquetado con bordes y bloques de k múltiples
+                assert(check_epilogue(3, 5, 7));
+                assert(check_epilogue(67, 45, 131));
+                assert(check_epilogue(130, 300, 70));
+                assert(check_layer(relu, relu_act, 13, 37, 9, 0.0));
+                assert(check_layer(relu, relu_act, 96, 130, 70, 0.0));
+                assert(check_layer(sigmoid, sigmoid_act, 13, 37, 9, 0.0));
+                assert(check_layer(sigmoid, sigmoid_act, 96, 130, 70, 0.0));
+                // Ruta CSR: un tercio de ceros basta con umbral 0.9
+                assert(check_layer(relu, relu_act, 40, 24, 6, 0.9));
+                std::cout << "FusedDense equivalente a Dense + activación con " << utec::algebra::gemm_isa_name(isa) << "\n";
+            }
+            utec::algebra::set_gemm_isa(previous);
+
+            // La red fusiona Dense + ReLU/Sigmoid al añadirlas y conserva el resultado
+            NeuralNetwork<float> net;
+            net.add_layer(std::make_unique<Dense<float>>(4, 8, ramp_init, ramp_init));
+            net.add_layer(std::make_unique<ReLU<float>>());
+            net.add_layer(std::make_unique<Dense<float>>(8, 3, ramp_init, ramp_init));
+            net.add_layer(std::make_unique<Sigmoid<float>>());
+            assert(net.num_layers() == 2);
+            Dense<float> l1(4, 8, ramp_init, ramp_init), l2(8, 3, ramp_init, ramp_init);
+            ReLU<float> r;
+            Sigmoid<float> s;
+            auto x = random(5, 4);
+            auto expected = s.forward(l2.forward(r.forward(l1.forward(x))));
+            auto predicted = net.predict(x);
+            for (size_t i = 0; i < expected.size(); ++i)
+                all_passed = all_passed && is_close(predicted[i], expected[i], 1e-5f);
+            assert(all_passed);
+
+            bool rejected = false;
+            try { LayerFactory<float>::create_fused_dense(4, 4, "tanh"); }
+            catch (const std::invalid_argument&) { rejected = true; }
+            assert(rejected);
+            std::cout << "NeuralNetwork fusiona Dense + activación al añadir capas\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test FusedDense: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Dense con epílogo de bias y activación fusionado", all_passed);
+    }
+};
+
+} // namespace tests
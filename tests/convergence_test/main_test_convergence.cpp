@@ -1,6 +1,9 @@
 // =============================================
 // tests/main_test_convergence.cpp
 // =============================================
+// Reemplaza operator new / delete para contar reservas (ver allocation_counter.h)
+#define UTEC_COUNT_ALLOCATIONS
+#include "../../include/utec/algebra/allocation_counter.h"
 #include "test_convergence.h"
 
 int main() {
@@ -3,10 +3,18 @@
 #include "../../include/utec/neural_network/neural_network.h"
 #include "../../include/utec/factories/nn_factory.h"
 #include "../../include/utec/algebra/tensor.h"
+#include "../../include/utec/algebra/reductions.h"
 #include "../../include/utec/loss_functions/nn_loss.h"
 #include "../../include/utec/optimizers/nn_optimizer.h"
+#include "../../include/utec/quantization/nn_quantization.h"
+#include "../../include/utec/algebra/allocation_counter.h"
 #include <chrono>
 #include <iomanip>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <thread>
+#include <algorithm>
 
 using utec::neural_network::LayerFactory;
 using utec::neural_network::NeuralNetwork;
@@ -14,6 +22,7 @@ using utec::neural_network::MSELoss;
 using utec::neural_network::BCELoss;
 using utec::neural_network::Adam;
 using utec::neural_network::SGD;
+using utec::neural_network::LossScaler;
 using utec::algebra::Tensor;
 
 namespace tests {
@@ -23,6 +32,12 @@ public:
         test_simple_xor_convergence();
         test_linear_regression_convergence();
         test_binary_classification_convergence();
+        test_half_precision_convergence();
+        test_int8_quantization();
+        test_steady_state_allocations();
+        test_data_parallel_training();
+        test_hogwild_training();
+        test_batch_prefetch();
         print_summary("TESTS DE CONVERGENCIA");
     }
 private:
@@ -38,36 +53,58 @@ private:
     float calculate_accuracy(const Tensor<float, 2>& predictions, const Tensor<float, 2>& targets) {
         size_t correct = 0;
         size_t total = predictions.shape()[0];
-        for (size_t i = 0; i < total; ++i) {
-            if (predictions.shape()[1] == 1) {
+        if (predictions.shape()[1] == 1) {
+            for (size_t i = 0; i < total; ++i) {
                 float pred = predictions(i, 0) > 0.5f ? 1.0f : 0.0f;
                 if (pred == targets(i, 0)) {
                     correct++;
                 }
-            } else {
-                size_t predicted_class = 0;
-                float max_pred = predictions(i, 0);
-                for (size_t j = 1; j < predictions.shape()[1]; ++j) {
-                    if (predictions(i, j) > max_pred) {
-                        max_pred = predictions(i, j);
-                        predicted_class = j;
-                    }
-                }
-                size_t actual_class = 0;
-                float max_actual = targets(i, 0);
-                for (size_t j = 1; j < targets.shape()[1]; ++j) {
-                    if (targets(i, j) > max_actual) {
-                        max_actual = targets(i, j);
-                        actual_class = j;
-                    }
-                }
-                if (predicted_class == actual_class) {
+            }
+        } else {
+            auto predicted_class = utec::algebra::argmax(predictions, 1);
+            auto actual_class = utec::algebra::argmax(targets, 1);
+            for (size_t i = 0; i < total; ++i) {
+                if (predicted_class[i] == actual_class[i]) {
                     correct++;
                 }
             }
         }
         return static_cast<float>(correct) / total;
     }
+    // n muestras de 16 entradas uniformes en [-1, 1]; la clase (de 4) es el cuadrante de (x0, x1)
+    std::pair<Tensor<float, 2>, Tensor<float, 2>> make_quadrant_data(size_t n, unsigned seed) {
+        Tensor<float, 2> X(n, 16), Y(n, 4);
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (size_t i = 0; i < X.size(); ++i) X[i] = dist(gen);
+        for (size_t i = 0; i < n; ++i) Y(i, (X(i, 0) > 0.0f) + 2 * (X(i, 1) > 0.0f)) = 1.0f;
+        return {std::move(X), std::move(Y)};
+    }
+    // Red 16-32-4 para make_quadrant_data, siempre con los mismos pesos iniciales
+    NeuralNetwork<float> build_quadrant_net(size_t replicas = 1) {
+        using utec::neural_network::Dense;
+        using utec::neural_network::ReLU;
+        using utec::neural_network::Sigmoid;
+        NeuralNetwork<float> net;
+        net.add_layer(std::make_unique<Dense<float>>(16, 32, ramp_init, ramp_init));
+        net.add_layer(std::make_unique<ReLU<float>>());
+        net.add_layer(std::make_unique<Dense<float>>(32, 4, ramp_init, ramp_init));
+        net.add_layer(std::make_unique<Sigmoid<float>>());
+        net.set_data_parallel(replicas);
+        return net;
+    }
+    const Tensor<float, 2>& dense_weights(const NeuralNetwork<float>& net, size_t layer) {
+        return dynamic_cast<const utec::neural_network::DenseBase<float>&>(net.layer(layer)).weights();
+    }
+    // Pesos de las dos capas densas de build_quadrant_net idénticos bit a bit
+    bool same_weights(const NeuralNetwork<float>& a, const NeuralNetwork<float>& b) {
+        for (size_t l = 0; l < 2; ++l) {
+            const auto& wa = dense_weights(a, l);
+            const auto& wb = dense_weights(b, l);
+            if (std::memcmp(wa.raw_data(), wb.raw_data(), wa.size() * sizeof(float)) != 0) return false;
+        }
+        return true;
+    }
     void test_simple_xor_convergence() {
         print_test_header("TEST DE CONVERGENCIA EN PROBLEMA XOR");
         bool all_passed = true;
@@ -274,5 +311,392 @@ private:
         }
         print_test_result("Test de convergencia clasificacion binaria", all_passed);
     }
+    // Regresión y = 2x + 1 entrenada con T (bf16 / fp16); devuelve {pérdida inicial, final}
+    template<typename T>
+    std::pair<float, float> train_half_regression(bool loss_scaling) {
+        const int n_samples = 64;
+        Tensor<float, 2> X(n_samples, 1), Y(n_samples, 1);
+        for (int i = 0; i < n_samples; ++i) {
+            X(i, 0) = static_cast<float>(i) / (n_samples - 1);
+            Y(i, 0) = 2.0f * X(i, 0) + 1.0f;
+        }
+        auto X_half = utec::algebra::tensor_cast<T>(X);
+        auto Y_half = utec::algebra::tensor_cast<T>(Y);
+
+        NeuralNetwork<T> nn;
+        nn.add_layer(LayerFactory<T>::create_dense(1, 16));
+        nn.add_layer(LayerFactory<T>::create_relu());
+        nn.add_layer(LayerFactory<T>::create_dense(16, 1));
+        if (loss_scaling) nn.enable_loss_scaling();
+
+        const float initial = calculate_mse_loss(utec::algebra::tensor_cast<float>(nn.predict(X_half)), Y);
+        nn.template train<MSELoss, Adam>(X_half, Y_half, 300, 16, 0, T(0.01f));
+        const float final_loss = calculate_mse_loss(utec::algebra::tensor_cast<float>(nn.predict(X_half)), Y);
+        if (loss_scaling) {
+            assert(nn.loss_scaler() != nullptr);
+            std::cout << "  Pasos descartados: " << nn.loss_scaler()->skipped_steps()
+                      << ", escala final: " << nn.loss_scaler()->scale() << "\n";
+        }
+        return {initial, final_loss};
+    }
+    void test_half_precision_convergence() {
+        print_test_header("TEST DE CONVERGENCIA CON BF16 / FP16");
+        bool all_passed = true;
+        try {
+            // El escalador descarta pasos con overflow y crece tras pasos válidos
+            LossScaler scaler(1024.0f, 2);
+            assert(!scaler.update(false));
+            assert(scaler.scale() == 512.0f && scaler.skipped_steps() == 1);
+            assert(scaler.update(true) && scaler.scale() == 512.0f);
+            assert(scaler.update(true) && scaler.scale() == 1024.0f);
+            std::cout << "LossScaler ajusta la escala correctamente\n";
+
+            // Gradientes escalados representables en fp16 cuyo valor sin escalar (1.5e-8) es
+            // menor que el subnormal mínimo: el optimizador debe deshacer la escala en float
+            using utec::algebra::fp16;
+            const float inv_scale = 1.0f / 65536.0f;
+            assert(static_cast<float>(fp16(1e-3f * inv_scale)) == 0.0f);
+            Tensor<fp16, 2> grads(1, 4);
+            grads.fill(fp16(1e-3f));
+            Tensor<fp16, 2> adam_params(1, 4), sgd_params(1, 4);
+            adam_params.fill(fp16(0.5f));
+            sgd_params.fill(fp16(0.0f));
+            Adam<fp16> adam(0.01f);
+            SGD<fp16> sgd(1e4f);
+            adam.set_gradient_scale(inv_scale);
+            sgd.set_gradient_scale(inv_scale);
+            adam.update(adam_params, grads);
+            sgd.update(sgd_params, grads);
+            for (size_t i = 0; i < grads.size(); ++i) {
+                assert(static_cast<float>(adam_params[i]) < 0.5f);
+                assert(static_cast<float>(sgd_params[i]) < 0.0f);
+            }
+            std::cout << "Los gradientes sin escalar por debajo del rango de fp16 mueven los pesos\n";
+
+            auto [bf_initial, bf_final] = train_half_regression<utec::algebra::bf16>(false);
+            std::cout << "bf16: perdida " << bf_initial << " -> " << bf_final << "\n";
+            assert(bf_final < bf_initial * 0.1f);
+            assert(bf_final < 0.1f);
+
+            auto [fp_initial, fp_final] = train_half_regression<utec::algebra::fp16>(true);
+            std::cout << "fp16 con escalado: perdida " << fp_initial << " -> " << fp_final << "\n";
+            assert(fp_final < fp_initial * 0.1f);
+            assert(fp_final < 0.1f);
+            std::cout << "Las redes de 16 bits convergen con pesos maestros en float\n";
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de convergencia con 16 bits: " << e.what() << "\n";
+            all_passed = false;
+        }
+        print_test_result("Test de convergencia bf16 / fp16", all_passed);
+    }
+    void test_int8_quantization() {
+        print_test_header("TEST DE CUANTIZACION INT8 POST-ENTRENAMIENTO");
+        bool all_passed = true;
+        try {
+            // 4 grupos en el plano (con coordenadas negativas: punto cero distinto de 0)
+            const size_t n_samples = 400;
+            std::mt19937 gen(16);
+            std::normal_distribution<float> noise(0.0f, 0.35f);
+            const float centers[4][2] = {{-1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}};
+            Tensor<float, 2> X(n_samples, 2), Y(n_samples, 4);
+            Y.fill(0.0f);
+            for (size_t i = 0; i < n_samples; ++i) {
+                const size_t c = i % 4;
+                X(i, 0) = centers[c][0] + noise(gen);
+                X(i, 1) = centers[c][1] + noise(gen);
+                Y(i, c) = 1.0f;
+            }
+
+            NeuralNetwork<float> nn;
+            nn.add_layer(LayerFactory<float>::create_dense(2, 32));
+            nn.add_layer(LayerFactory<float>::create_relu());
+            nn.add_layer(LayerFactory<float>::create_dense(32, 16));
+            nn.add_layer(LayerFactory<float>::create_relu());
+            nn.add_layer(LayerFactory<float>::create_dense(16, 4));
+            nn.add_layer(LayerFactory<float>::create_sigmoid());
+            nn.train<BCELoss, Adam>(X, Y, 100, 20, 0, 0.01f);
+
+            auto quantized = utec::neural_network::quantize_int8(nn, X, 256);
+            assert(quantized.num_stages() == 3);
+            assert(quantized.stage(0).requantizes() && quantized.stage(1).requantizes());
+            assert(!quantized.stage(2).requantizes());
+
+            auto float_pred = nn.predict(X);
+            auto int8_pred = quantized.predict(X);
+            assert(int8_pred.shape()[0] == n_samples && int8_pred.shape()[1] == 4);
+            auto float_class = utec::algebra::argmax(float_pred, 1);
+            auto int8_class = utec::algebra::argmax(int8_pred, 1);
+            auto expected = utec::algebra::argmax(Y, 1);
+            size_t float_correct = 0, int8_correct = 0, agree = 0;
+            float max_diff = 0.0f;
+            for (size_t i = 0; i < n_samples; ++i) {
+                float_correct += float_class[i] == expected[i];
+                int8_correct += int8_class[i] == expected[i];
+                agree += int8_class[i] == float_class[i];
+                for (size_t j = 0; j < 4; ++j)
+                    max_diff = std::max(max_diff, std::abs(float_pred(i, j) - int8_pred(i, j)));
+            }
+            std::cout << "Precision float: " << 100.0f * float_correct / n_samples
+                      << "%, int8: " << 100.0f * int8_correct / n_samples
+                      << "%, coincidencia: " << 100.0f * agree / n_samples
+                      << "%, diferencia maxima: " << max_diff << "\n";
+            assert(float_correct > n_samples * 9 / 10);
+            assert(int8_correct + n_samples / 50 >= float_correct);
+            assert(agree >= n_samples * 95 / 100);
+            assert(max_diff < 0.15f);
+
+            // Capas que no son Dense [ReLU | Sigmoid] se rechazan
+            NeuralNetwork<float> unsupported;
+            unsupported.add_layer(LayerFactory<float>::create_relu());
+            bool threw = false;
+            try {
+                utec::neural_network::quantize_int8(unsupported, X);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+            std::cout << "La red int8 reproduce las predicciones del modelo en float\n";
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de cuantizacion int8: " << e.what() << "\n";
+            all_passed = false;
+        }
+        print_test_result("Test de cuantizacion int8", all_passed);
+    }
+    void test_steady_state_allocations() {
+        print_test_header("TEST SIN RESERVAS DE MEMORIA EN ESTADO ESTABLE");
+        bool all_passed = true;
+        try {
+            if (!utec::algebra::allocation_counting_enabled()) {
+                std::cout << "Contador no instalado (UTEC_COUNT_ALLOCATIONS); se omite\n";
+                print_test_result("Entrenamiento sin reservas de memoria", all_passed);
+                return;
+            }
+            // 103 muestras en lotes de 10: el último lote es más corto. Con ~40% de ceros
+            // en la entrada, la primera Dense usa además la ruta CSR.
+            Tensor<float, 2> X(103, 64), Y(103, 10);
+            std::mt19937 gen(18);
+            std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+            for (size_t i = 0; i < X.size(); ++i) X[i] = dist(gen) < 0.4f ? dist(gen) : 0.0f;
+            for (size_t i = 0; i < 103; ++i) Y(i, i % 10) = 1.0f;
+
+            using namespace utec::neural_network;
+            auto build = [] {
+                NeuralNetwork<float> net;
+                net.add_layer(LayerFactory<float>::create_dense(64, 32));
+                net.add_layer(LayerFactory<float>::create_relu());
+                net.add_layer(LayerFactory<float>::create_dense(32, 10));
+                net.add_layer(LayerFactory<float>::create_sigmoid());
+                return net;
+            };
+
+            // SGD no guarda estado: tras el primer lote, entrenar no reserva nada
+            auto net = build();
+            net.train<MSELoss, SGD>(X, Y, 1, 10, 0, 0.1f);
+            utec::algebra::AllocationScope sgd_scope;
+            net.train<MSELoss, SGD>(X, Y, 3, 10, 0, 0.1f);
+            std::cout << "SGD, 33 pasos: " << sgd_scope.allocations() << " reservas\n";
+            assert(sgd_scope.allocations() == 0);
+
+            // Adam reserva su estado una vez por llamada, no por paso
+            auto adam_net = build();
+            adam_net.train<BCELoss, Adam>(X, Y, 1, 10, 0, 0.01f);
+            utec::algebra::AllocationScope one_epoch;
+            adam_net.train<BCELoss, Adam>(X, Y, 1, 10, 0, 0.01f);
+            const size_t per_call = one_epoch.allocations();
+            utec::algebra::AllocationScope four_epochs;
+            adam_net.train<BCELoss, Adam>(X, Y, 4, 10, 0, 0.01f);
+            std::cout << "Adam: " << per_call << " reservas con 1 epoca, "
+                      << four_epochs.allocations() << " con 4\n";
+            assert(four_epochs.allocations() == per_call);
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de reservas: " << e.what() << "\n";
+            all_passed = false;
+        }
+        print_test_result("Entrenamiento sin reservas de memoria", all_passed);
+    }
+    void test_data_parallel_training() {
+        print_test_header("TEST ENTRENAMIENTO EN PARALELO DE DATOS");
+        bool all_passed = true;
+        try {
+            // 203 muestras en lotes de 10: tramos de 2 y 3 filas y un último lote de 3 filas
+            // para 4 réplicas
+            const auto [X, Y] = make_quadrant_data(203, 22);
+
+            // Mismas réplicas con 1 y con 4 hilos: idéntico bit a bit (Adam y SGD)
+            ThreadCountGuard threads(1);
+            auto serial = build_quadrant_net(4);
+            serial.train<MSELoss, Adam>(X, Y, 3, 10, 0, 0.01f);
+            utec::algebra::set_num_threads(4);
+            auto threaded = build_quadrant_net(4);
+            threaded.train<MSELoss, Adam>(X, Y, 3, 10, 0, 0.01f);
+            all_passed = all_passed && same_weights(serial, threaded);
+            assert(all_passed);
+            std::cout << "4 réplicas con 1 y 4 hilos: pesos idénticos bit a bit\n";
+
+            // Frente a una sola réplica solo cambia el redondeo de la suma de gradientes
+            auto single = build_quadrant_net();
+            auto replicated = build_quadrant_net(3);
+            single.train<BCELoss, SGD>(X, Y, 2, 10, 0, 0.1f);
+            replicated.train<BCELoss, SGD>(X, Y, 2, 10, 0, 0.1f);
+            for (size_t l = 0; l < 2; ++l) {
+                const auto& a = dense_weights(single, l);
+                const auto& b = dense_weights(replicated, l);
+                for (size_t i = 0; i < a.size(); ++i)
+                    all_passed = all_passed && is_close(a[i], b[i], 1e-4f);
+            }
+            assert(all_passed);
+            std::cout << "3 réplicas frente a entrenamiento en serie: mismos pesos (tolerancia 1e-4)\n";
+
+            // Las réplicas parten de los pesos actuales: un train en serie intermedio se respeta
+            replicated.set_data_parallel(1);
+            single.train<BCELoss, SGD>(X, Y, 1, 10, 0, 0.1f);
+            replicated.train<BCELoss, SGD>(X, Y, 1, 10, 0, 0.1f);
+            replicated.set_data_parallel(3);
+            single.set_data_parallel(3);
+            single.train<BCELoss, SGD>(X, Y, 1, 10, 0, 0.1f);
+            replicated.train<BCELoss, SGD>(X, Y, 1, 10, 0, 0.1f);
+            auto p1 = single.predict(X), p2 = replicated.predict(X);
+            for (size_t i = 0; i < p1.size(); ++i) all_passed = all_passed && is_close(p1[i], p2[i], 1e-4f);
+            assert(all_passed);
+
+            if (utec::algebra::allocation_counting_enabled()) {
+                utec::algebra::AllocationScope scope;
+                replicated.train<BCELoss, SGD>(X, Y, 2, 10, 0, 0.1f);
+                std::cout << "Réplicas en estado estable: " << scope.allocations() << " reservas\n";
+                assert(scope.allocations() == 0);
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Error en paralelo de datos: " << e.what() << "\n";
+            all_passed = false;
+        }
+        print_test_result("Entrenamiento en paralelo de datos", all_passed);
+    }
+    void test_hogwild_training() {
+        print_test_header("TEST SGD ASINCRONO (HOGWILD)");
+        bool all_passed = true;
+        try {
+            const auto [X, Y] = make_quadrant_data(400, 23);
+
+            // Con un solo hilo no hay carreras: mismo resultado que SGD síncrono
+            auto sync = build_quadrant_net();
+            auto async = build_quadrant_net();
+            sync.train<BCELoss, SGD>(X, Y, 3, 8, 0, 0.5f);
+            async.train_async<BCELoss>(X, Y, 3, 8, 0, 0.5f, 1);
+            all_passed = all_passed && same_weights(sync, async);
+            assert(all_passed);
+            std::cout << "1 hilo: mismos pesos que SGD sincrono\n";
+
+            // Con 4 hilos el orden de las escrituras varía, pero la red aprende igual
+            ThreadCountGuard threads(4);
+            auto hogwild = build_quadrant_net();
+            const float initial = calculate_mse_loss(hogwild.predict(X), Y);
+            hogwild.train_async<BCELoss>(X, Y, 40, 8, 0, 0.5f);
+            auto predictions = hogwild.predict(X);
+            const float accuracy = calculate_accuracy(predictions, Y);
+            std::cout << "4 hilos: precision " << accuracy * 100.0f << "%\n";
+            assert(calculate_mse_loss(predictions, Y) < initial);
+            assert(accuracy > 0.85f);
+        } catch (const std::exception& e) {
+            std::cout << "Error en Hogwild: " << e.what() << "\n";
+            all_passed = false;
+        }
+        print_test_result("SGD asincrono sin bloqueos", all_passed);
+    }
+    void test_batch_prefetch() {
+        print_test_header("TEST PRECARGA DE LOTES EN SEGUNDO PLANO");
+        bool all_passed = true;
+        try {
+            using utec::neural_network::SpscRing;
+            using utec::neural_network::BatchPrefetcher;
+            using utec::neural_network::BatchPrefetchOptions;
+
+            // La cola entrega todo, en orden, entre dos hilos
+            SpscRing<size_t, 4> ring;
+            std::thread producer([&] { for (size_t i = 0; i < 10000; ++i) ring.push(i); });
+            for (size_t i = 0; i < 10000; ++i) all_passed = all_passed && ring.pop() == i;
+            producer.join();
+            assert(all_passed);
+
+            // Barajado: cada época recorre todas las filas una vez y X / Y siguen emparejadas
+            Tensor<float, 2> rows(50, 3), labels(50, 1);
+            for (size_t i = 0; i < 50; ++i) {
+                for (size_t j = 0; j < 3; ++j) rows(i, j) = static_cast<float>(i);
+                labels(i, 0) = static_cast<float>(i);
+            }
+            BatchPrefetchOptions<float> shuffled;
+            shuffled.buffers = 2;
+            shuffled.shuffle = true;
+            bool reordered = false;
+            {
+                BatchPrefetcher<float> prefetcher(rows, labels, 8, 2, shuffled);
+                for (size_t epoch = 0; epoch < 2; ++epoch) {
+                    std::vector<int> seen(50, 0);
+                    for (size_t b = 0, position = 0; b < 7; ++b) {
+                        auto batch = prefetcher.next();
+                        all_passed = all_passed && batch.X.shape()[0] == (b < 6 ? 8u : 2u);
+                        for (size_t i = 0; i < batch.X.shape()[0]; ++i, ++position) {
+                            const size_t r = static_cast<size_t>(batch.X(i, 0));
+                            seen[r]++;
+                            reordered = reordered || r != position;
+                            all_passed = all_passed && batch.X(i, 2) == batch.Y(i, 0);
+                        }
+                        prefetcher.release(batch);
+                    }
+                    all_passed = all_passed && std::all_of(seen.begin(), seen.end(), [](int c) { return c == 1; });
+                }
+                bool exhausted = false;
+                try { prefetcher.next(); } catch (const std::out_of_range&) { exhausted = true; }
+                all_passed = all_passed && exhausted && reordered;
+            }
+            assert(all_passed);
+            std::cout << "Cola SPSC en orden; cada epoca barajada cubre todas las filas una vez\n";
+
+            const auto [X, Y] = make_quadrant_data(400, 29);
+
+            // Sin barajar, los lotes precargados son los mismos: pesos idénticos bit a bit
+            auto plain = build_quadrant_net();
+            auto prefetched = build_quadrant_net();
+            prefetched.enable_prefetch();
+            plain.train<BCELoss, SGD>(X, Y, 3, 32, 0, 0.5f);
+            prefetched.train<BCELoss, SGD>(X, Y, 3, 32, 0, 0.5f);
+            assert(prefetched.prefetch_enabled());
+            all_passed = all_passed && same_weights(plain, prefetched);
+            assert(all_passed);
+            std::cout << "Sin barajar: mismos pesos que sin precarga\n";
+
+            // Barajado con la misma semilla: reproducible, y la red aprende
+            BatchPrefetchOptions<float> options;
+            options.shuffle = true;
+            auto first = build_quadrant_net();
+            auto second = build_quadrant_net();
+            first.enable_prefetch(options);
+            second.enable_prefetch(options);
+            const float initial = calculate_mse_loss(first.predict(X), Y);
+            first.train<BCELoss, SGD>(X, Y, 30, 8, 0, 0.5f);
+            second.train<BCELoss, SGD>(X, Y, 30, 8, 0, 0.5f);
+            all_passed = all_passed && same_weights(first, second);
+            auto predictions = first.predict(X);
+            const float accuracy = calculate_accuracy(predictions, Y);
+            std::cout << "Barajado: precision " << accuracy * 100.0f << "%\n";
+            assert(all_passed);
+            assert(calculate_mse_loss(predictions, Y) < initial);
+            assert(accuracy > 0.85f);
+
+            // Un error en el hilo productor llega a train, que termina sin tocar los pesos
+            BatchPrefetchOptions<float> failing;
+            failing.transform = [](Tensor<float, 2>&, Tensor<float, 2>&) { throw std::runtime_error("bad batch"); };
+            auto broken = build_quadrant_net();
+            auto untouched = build_quadrant_net();
+            broken.enable_prefetch(failing);
+            broken.train<BCELoss, SGD>(X, Y, 2, 32, 0, 0.5f);
+            all_passed = all_passed && same_weights(broken, untouched);
+            assert(all_passed);
+            std::cout << "Los errores de transform detienen el entrenamiento\n";
+        } catch (const std::exception& e) {
+            std::cout << "Error en precarga de lotes: " << e.what() << "\n";
+            all_passed = false;
+        }
+        print_test_result("Precarga de lotes en segundo plano", all_passed);
+    }
 };
 } // namespace tests
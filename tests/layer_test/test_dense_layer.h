@@ -2,8 +2,11 @@
 
 #include "../test_base.h"
 #include "../../include/utec/neural_network/neural_network.h"
+#include "../../include/utec/neural_network/static_network.h"
 #include "../../include/utec/factories/nn_factory.h"
 #include "../../include/utec/algebra/tensor.h"
+#include <thread>
+#include <vector>
 
 using utec::neural_network::LayerFactory;
 using utec::algebra::Tensor;
@@ -17,6 +20,11 @@ public:
         test_dense_layer_forward_pass();
         test_dense_layer_backward_pass();
         test_dense_layer_dimensions();
+        test_dense_layer_into_buffers();
+        test_static_dense_layer();
+        test_forward_inference();
+        test_parallel_predict();
+        test_static_network();
         print_summary("TESTS DE CAPA DENSA");
     }
 
@@ -190,6 +198,326 @@ private:
         
         print_test_result("Test de dimensiones de capa densa", all_passed);
     }
+
+    void test_dense_layer_into_buffers() {
+        print_test_header("TEST FORWARD_INTO / BACKWARD_INTO DE CAPA DENSA");
+
+        bool all_passed = true;
+
+        try {
+            auto dense_layer = LayerFactory<float>::create_dense(4, 3);
+
+            Tensor<float, 2> input(10, 4);
+            for (size_t i = 0; i < input.size(); ++i) input[i] = 0.1f * static_cast<float>(i % 7);
+            Tensor<float, 2> grad(10, 3);
+            grad.fill(0.5f);
+
+            auto expected_out = dense_layer->forward(input);
+            auto expected_grad = dense_layer->backward(grad);
+
+            Tensor<float, 2> out(0, 0), grad_in(0, 0);
+            dense_layer->forward_into(input, out);
+            dense_layer->backward_into(grad, grad_in);
+            const float* out_buffer = out.raw_data();
+            const float* grad_buffer = grad_in.raw_data();
+
+            for (size_t i = 0; i < out.size(); ++i) assert(is_close(out[i], expected_out[i]));
+            for (size_t i = 0; i < grad_in.size(); ++i) assert(is_close(grad_in[i], expected_grad[i]));
+            std::cout << "forward_into/backward_into coinciden con forward/backward\n";
+
+            // Lote mas pequeno y luego de vuelta al tamano original: mismos buffers
+            dense_layer->forward_into(utec::algebra::rows(input, 0, 3), out);
+            assert(out.shape()[0] == 3 && out.shape()[1] == 3);
+            dense_layer->forward_into(input, out);
+            dense_layer->backward_into(grad, grad_in);
+            assert(out.raw_data() == out_buffer);
+            assert(grad_in.raw_data() == grad_buffer);
+            std::cout << "Los buffers del llamador se reutilizan entre lotes\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en test de buffers: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("forward_into/backward_into de capa densa", all_passed);
+    }
+
+    template<size_t In, size_t Out>
+    bool check_static_dense(size_t batch) {
+        utec::neural_network::Dense<float> dynamic_layer(In, Out, ramp_init, ramp_init);
+        utec::neural_network::Dense<float, In, Out> static_layer(ramp_init, ramp_init);
+
+        Tensor<float, 2> input(batch, In), grad(batch, Out);
+        for (size_t i = 0; i < input.size(); ++i) input[i] = 0.1f * static_cast<float>(i % 7) - 0.3f;
+        for (size_t i = 0; i < grad.size(); ++i) grad[i] = 0.05f * static_cast<float>(i % 5);
+
+        utec::neural_network::SGD<float> sgd(0.1f);
+        bool ok = true;
+        for (int step = 0; step < 2; ++step) {
+            auto y1 = dynamic_layer.forward(input);
+            auto y2 = static_layer.forward(input);
+            auto g1 = dynamic_layer.backward(grad);
+            auto g2 = static_layer.backward(grad);
+            ok = ok && y1.shape() == y2.shape() && g1.shape() == g2.shape();
+            for (size_t i = 0; ok && i < y1.size(); ++i) ok = is_close(y1[i], y2[i], 1e-4f);
+            for (size_t i = 0; ok && i < g1.size(); ++i) ok = is_close(g1[i], g2[i], 1e-4f);
+            dynamic_layer.update_params(sgd);
+            static_layer.update_params(sgd);
+        }
+        return ok;
+    }
+
+    void test_static_dense_layer() {
+        print_test_header("TEST CAPA DENSA CON DIMENSIONES ESTATICAS");
+
+        bool all_passed = true;
+
+        try {
+            static_assert(utec::neural_network::Dense<float, 4, 3>::input_size() == 4);
+            static_assert(utec::neural_network::Dense<float, 4, 3>::output_size() == 3);
+
+            // Kernels de tamano fijo (4x3) y camino por GEMM (96x80)
+            assert((check_static_dense<4, 3>(10)));
+            assert((check_static_dense<96, 80>(37)));
+            std::cout << "Dense<T, In, Out> coincide con Dense<T> en forward, backward y actualizacion\n";
+
+            utec::neural_network::Dense<float, 4, 3> layer([](Tensor<float, 2>& w) { w.fill(1.0f); },
+                                                           [](Tensor<float, 2>& b) { b.fill(0.0f); });
+            bool threw = false;
+            try {
+                layer.forward(Tensor<float, 2>(2, 5));
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+            std::cout << "Una entrada con ancho distinto de In se rechaza\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en capa densa estatica: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Capa densa con dimensiones estaticas", all_passed);
+    }
+
+    // forward_inference da lo mismo que forward sin tocar lo que guarda la capa
+    bool same_inference(utec::neural_network::ILayer<float>& layer, const Tensor<float, 2>& x,
+                        const Tensor<float, 2>& other, const Tensor<float, 2>& grad) {
+        auto y = layer.forward(x);
+        auto gx = layer.backward(grad);
+        Tensor<float, 2> y_inf(0, 0), unused(0, 0);
+        const auto& frozen = layer;
+        frozen.forward_inference(x, y_inf);
+        if (y_inf.shape() != y.shape()) return false;
+        for (size_t i = 0; i < y.size(); ++i)
+            if (!is_close(y_inf[i], y[i], 1e-5f)) return false;
+        // Una inferencia con otra entrada entre forward y backward no cambia el gradiente
+        layer.forward(x);
+        frozen.forward_inference(other, unused);
+        auto gx_after = layer.backward(grad);
+        for (size_t i = 0; i < gx.size(); ++i)
+            if (gx_after[i] != gx[i]) return false;
+        return true;
+    }
+
+    void test_forward_inference() {
+        print_test_header("TEST FORWARD DE INFERENCIA (CONST)");
+
+        bool all_passed = true;
+
+        try {
+            using utec::neural_network::Dense;
+            using utec::neural_network::FusedDense;
+            using utec::neural_network::ReLU;
+            using utec::neural_network::Sigmoid;
+            using utec::neural_network::NeuralNetwork;
+            // Un tercio de ceros: con el umbral CSR por defecto Dense toma la ruta dispersa
+            auto input = [](size_t rows, size_t cols, size_t seed) {
+                Tensor<float, 2> x(rows, cols);
+                for (size_t i = 0; i < x.size(); ++i)
+                    x[i] = (i + seed) % 3 == 0 ? 0.0f : 0.1f * static_cast<float>((i * 7 + seed) % 11) - 0.5f;
+                return x;
+            };
+
+            Dense<float> dense(24, 16, ramp_init, ramp_init);
+            Dense<float> dense_gemm(24, 16, ramp_init, ramp_init);
+            dense_gemm.set_sparse_threshold(0.0);
+            FusedDense<float, ReLU> fused_relu(24, 16, ramp_init, ramp_init);
+            FusedDense<float, Sigmoid> fused_sigmoid(24, 16, ramp_init, ramp_init);
+            Dense<float, 24, 16> static_dense(ramp_init, ramp_init);
+            ReLU<float> relu;
+            Sigmoid<float> sigmoid;
+            auto sparse_x = input(9, 24, 1), dense_x = input(9, 24, 1), other = input(5, 24, 2);
+            for (size_t i = 0; i < dense_x.size(); ++i) dense_x[i] += 0.01f;
+            auto grad = input(9, 16, 3);
+            for (auto* x : {&sparse_x, &dense_x}) {
+                assert(same_inference(dense, *x, other, grad));
+                assert(same_inference(dense_gemm, *x, other, grad));
+                assert(same_inference(fused_relu, *x, other, grad));
+                assert(same_inference(fused_sigmoid, *x, other, grad));
+                assert(same_inference(static_dense, *x, other, grad));
+            }
+            auto act_x = input(9, 16, 4);
+            assert(same_inference(relu, act_x, input(5, 16, 5), grad));
+            assert(same_inference(sigmoid, act_x, input(5, 16, 5), grad));
+            std::cout << "Dense, FusedDense, Dense<T, In, Out>, ReLU y Sigmoid: inferencia igual a forward\n";
+
+            // predict es const: varios hilos comparten la misma red
+            NeuralNetwork<float> net;
+            net.add_layer(std::make_unique<Dense<float>>(24, 32, ramp_init, ramp_init));
+            net.add_layer(std::make_unique<ReLU<float>>());
+            net.add_layer(std::make_unique<Dense<float>>(32, 5, ramp_init, ramp_init));
+            net.add_layer(std::make_unique<Sigmoid<float>>());
+            const NeuralNetwork<float>& shared = net;
+            auto X = input(250, 24, 6);
+            auto expected = shared.predict(X);
+            assert(expected.shape()[0] == 250 && expected.shape()[1] == 5);
+            std::vector<Tensor<float, 2>> results(4, Tensor<float, 2>(0, 0));
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < results.size(); ++t)
+                workers.emplace_back([&, t] { for (int r = 0; r < 3; ++r) results[t] = shared.predict(X); });
+            for (auto& w : workers) w.join();
+            for (const auto& r : results) {
+                if (r.shape() != expected.shape()) { all_passed = false; continue; }
+                for (size_t i = 0; i < r.size(); ++i)
+                    all_passed = all_passed && r[i] == expected[i];
+            }
+            assert(all_passed);
+            std::cout << "NeuralNetwork::predict const desde 4 hilos: mismos resultados\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en forward de inferencia: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Forward de inferencia sin caché", all_passed);
+    }
+
+    void test_parallel_predict() {
+        print_test_header("TEST PREDICT REPARTIDO ENTRE HILOS");
+
+        bool all_passed = true;
+
+        try {
+            using utec::neural_network::Dense;
+            using utec::neural_network::ReLU;
+            using utec::neural_network::Sigmoid;
+            using utec::neural_network::NeuralNetwork;
+
+            NeuralNetwork<float> net;
+            net.add_layer(std::make_unique<Dense<float>>(12, 40, ramp_init, ramp_init));
+            net.add_layer(std::make_unique<ReLU<float>>());
+            net.add_layer(std::make_unique<Dense<float, 40, 3>>(ramp_init, ramp_init));
+            net.add_layer(std::make_unique<Sigmoid<float>>());
+
+            Tensor<float, 2> X(1003, 12);
+            for (size_t i = 0; i < X.size(); ++i) X[i] = 0.1f * static_cast<float>((i * 5) % 13) - 0.6f;
+
+            // Referencia: un solo lote con todas las filas, recorriendo las capas a mano
+            Tensor<float, 2> expected(0, 0), next(0, 0);
+            net.layer(0).forward_inference(X, expected);
+            for (size_t i = 1; i < net.num_layers(); ++i) {
+                net.layer(i).forward_inference(expected, next);
+                std::swap(expected, next);
+            }
+
+            ThreadCountGuard restore;
+            for (size_t threads : {1, 3, 4}) {
+                utec::algebra::set_num_threads(threads);
+                for (size_t batch : {1, 7, 100, 1003, 5000}) {
+                    auto predicted = net.predict(X, batch);
+                    assert(predicted.shape()[0] == 1003 && predicted.shape()[1] == 3);
+                    for (size_t i = 0; i < expected.size(); ++i)
+                        all_passed = all_passed && is_close(predicted[i], expected[i], 1e-5f);
+                }
+            }
+            assert(all_passed);
+            std::cout << "1, 3 y 4 hilos con lotes de 1 a 5000 filas dan el mismo resultado\n";
+
+            // El ancho de salida sale de las capas: sin filas no hay forward
+            auto empty = net.predict(Tensor<float, 2>(0, 12));
+            assert(empty.shape()[0] == 0 && empty.shape()[1] == 3);
+
+            bool zero_batch = false, bad_width = false;
+            try { net.predict(X, 0); } catch (const std::invalid_argument&) { zero_batch = true; }
+            try { net.predict(Tensor<float, 2>(4, 11)); } catch (const std::invalid_argument&) { bad_width = true; }
+            assert(zero_batch && bad_width);
+            std::cout << "Lote 0 y entradas de ancho incorrecto se rechazan antes de calcular\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en predict paralelo: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Predict repartido entre hilos", all_passed);
+    }
+
+    void test_static_network() {
+        print_test_header("TEST RED ESTATICA (StaticNetwork)");
+
+        bool all_passed = true;
+
+        try {
+            using utec::neural_network::Dense;
+            using utec::neural_network::FusedDense;
+            using utec::neural_network::ReLU;
+            using utec::neural_network::Sigmoid;
+            using utec::neural_network::MSELoss;
+            using utec::neural_network::NeuralNetwork;
+            using utec::neural_network::StaticNetwork;
+
+            static_assert(utec::neural_network::detail::compatible_widths<Dense<float, 4, 3>, ReLU<float>,
+                                                                          Dense<float>, Dense<float, 5, 2>>());
+            static_assert(!utec::neural_network::detail::compatible_widths<Dense<float, 4, 3>, ReLU<float>,
+                                                                           Dense<float, 4, 2>>());
+
+            // La red dinámica fusiona Dense + ReLU: ambas hacen exactamente las mismas cuentas
+            NeuralNetwork<float> dynamic_net;
+            dynamic_net.add_layer(std::make_unique<Dense<float>>(12, 16, ramp_init, ramp_init));
+            dynamic_net.add_layer(std::make_unique<ReLU<float>>());
+            dynamic_net.add_layer(std::make_unique<Dense<float, 16, 3>>(ramp_init, ramp_init));
+            dynamic_net.add_layer(std::make_unique<Sigmoid<float>>());
+
+            StaticNetwork<float, FusedDense<float, ReLU>, Dense<float, 16, 3>, Sigmoid<float>> static_net(
+                FusedDense<float, ReLU>(12, 16, ramp_init, ramp_init), Dense<float, 16, 3>(ramp_init, ramp_init),
+                Sigmoid<float>());
+            static_assert(decltype(static_net)::num_layers() == 3);
+            assert(static_net.input_width() == 12 && static_net.output_width() == 3);
+
+            Tensor<float, 2> X(96, 12), Y(96, 3);
+            for (size_t i = 0; i < X.size(); ++i) X[i] = 0.1f * static_cast<float>((i * 5) % 13) - 0.6f;
+            for (size_t i = 0; i < 96; ++i) Y(i, (i * 7) % 3) = 1.0f;
+
+            dynamic_net.train<MSELoss>(X, Y, 5, 16, 0, 0.5f);
+            static_net.train<MSELoss>(X, Y, 5, 16, 0, 0.5f);
+
+            auto expected = dynamic_net.predict(X, 10);
+            auto predicted = static_net.predict(X, 10);
+            assert(predicted.shape() == expected.shape());
+            for (size_t i = 0; i < expected.size(); ++i)
+                all_passed = all_passed && is_close(predicted[i], expected[i], 1e-6f);
+            assert(all_passed);
+            std::cout << "Entrenada igual que NeuralNetwork, la red estatica predice lo mismo\n";
+
+            // Anchos dinámicos: se validan una sola vez, al construir
+            bool bad_chain = false, bad_input = false, bad_batch = false;
+            try {
+                StaticNetwork<float, Dense<float>, ReLU<float>, Dense<float>> broken(
+                    Dense<float>(12, 16, ramp_init, ramp_init), ReLU<float>(),
+                    Dense<float>(8, 3, ramp_init, ramp_init));
+            } catch (const std::invalid_argument&) { bad_chain = true; }
+            try { static_net.predict(Tensor<float, 2>(4, 11)); } catch (const std::invalid_argument&) { bad_input = true; }
+            try { static_net.train<MSELoss>(X, Y, 1, 0, 0, 0.5f); } catch (const std::invalid_argument&) { bad_batch = true; }
+            assert(bad_chain && bad_input && bad_batch);
+            std::cout << "Capas incompatibles, entradas de ancho incorrecto y lote 0 se rechazan\n";
+
+        } catch (const std::exception& e) {
+            std::cout << "Error en red estatica: " << e.what() << "\n";
+            all_passed = false;
+        }
+
+        print_test_result("Red estatica", all_passed);
+    }
 };
 
 } // namespace tests
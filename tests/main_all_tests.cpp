@@ -1,6 +1,10 @@
+// Reemplaza operator new / delete para contar reservas (ver allocation_counter.h)
+#define UTEC_COUNT_ALLOCATIONS
+#include "../include/utec/algebra/allocation_counter.h"
 #include "layer_test/test_dense_layer.h"
 #include "activation_test/test_activations.h"
 #include "convergence_test/test_convergence.h"
+#include "algebra_test/test_tensor_algebra.h"
 #include <iostream>
 #include <chrono>
 
@@ -14,6 +18,15 @@ int main() {
     int total_tests = 0;
     int total_passed = 0;
     
+    // Ejecutar tests de algebra tensorial
+    {
+        std::cout << "\nINICIANDO TESTS DE ALGEBRA TENSORIAL...\n";
+        tests::TestTensorAlgebra test_algebra;
+        test_algebra.run_tests();
+        total_tests += test_algebra.get_tests_total();
+        total_passed += test_algebra.get_tests_passed();
+    }
+    
     // Ejecutar tests de capas densas
     {
         std::cout << "\nINICIANDO TESTS DE CAPAS DENSAS...\n";
@@ -5,9 +5,24 @@
 #include <cmath>
 #include <cassert>
 #include <iomanip>
+#include "../include/utec/algebra/thread_pool.h"
 
 namespace tests {
 
+    // Fija el número de hilos del pool global y restaura el anterior al salir del ámbito,
+    // también si el test lanza: así un fallo no deja el pool cambiado para los siguientes
+    class ThreadCountGuard {
+        size_t previous_;
+
+    public:
+        ThreadCountGuard() : previous_(utec::algebra::num_threads()) {}
+        explicit ThreadCountGuard(size_t threads) : ThreadCountGuard() { utec::algebra::set_num_threads(threads); }
+        ~ThreadCountGuard() { utec::algebra::set_num_threads(previous_); }
+
+        ThreadCountGuard(const ThreadCountGuard&) = delete;
+        ThreadCountGuard& operator=(const ThreadCountGuard&) = delete;
+    };
+
     class TestBase {
     protected:
         int tests_passed = 0;
@@ -33,6 +48,12 @@ namespace tests {
             return std::abs(a - b) < tolerance;
         }
 
+        // Inicializador determinista de pesos y sesgos: rampa periódica con ambos signos.
+        // Los tests que comparan dos caminos de cálculo lo pasan a las dos capas o redes
+        static constexpr auto ramp_init = [](auto& t) {
+            for (size_t i = 0; i < t.size(); ++i) t[i] = 0.01f * static_cast<float>(i % 23) - 0.11f;
+        };
+
     public:
         virtual ~TestBase() = default;
         virtual void run_tests() = 0;